@@ -1,3 +1,4 @@
+import argparse
 import numpy as np
 from pathlib import Path
 from typing import Tuple
@@ -129,6 +130,18 @@ def save_matrix_to_file(matrix: np.ndarray, filename: str) -> None:
                 f.write('\n')
 
 
+def save_matrix_to_npy(matrix: np.ndarray, filename: str) -> None:
+
+    file_path = Path("./data/" + filename)
+
+    # An empty matrix is stored as 0x0 rather than the 1x0 it is built as
+    if matrix.size == 0:
+        matrix = np.empty((0, 0), dtype=np.float64)
+
+    # C-order float64 is what the reader maps without copying
+    np.save(file_path, np.ascontiguousarray(matrix, dtype=np.float64), allow_pickle=False)
+
+
 def get_user_input() -> Tuple[int, float]:
 
     try:
@@ -143,7 +156,16 @@ def get_user_input() -> Tuple[int, float]:
         raise
 
 
+def parse_arguments() -> argparse.Namespace:
+
+    parser = argparse.ArgumentParser(description="Generate an NxN matrix with a given determinant into ./data")
+    parser.add_argument("--format", choices=["npy", "txt"], default="npy",
+                        help="npy: binary NumPy array, read without parsing (default); txt: decimal text rows")
+    return parser.parse_args()
+
+
 def main():
+    args = parse_arguments()
     N, D = get_user_input()
         
     print(f"\nGenerating {N}x{N} matrix with determinant {D}...")
@@ -161,8 +183,11 @@ def main():
         print(f"Expected: {D}, Got: {actual_det}")
         return
     
-    filename = f"matrix_{N}_{D:.2f}.txt"
-    save_matrix_to_file(matrix, filename)
+    filename = f"matrix_{N}_{D:.2f}.{args.format}"
+    if args.format == "npy":
+        save_matrix_to_npy(matrix, filename)
+    else:
+        save_matrix_to_file(matrix, filename)
 
 
 if __name__ == "__main__":
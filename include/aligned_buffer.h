@@ -0,0 +1,135 @@
+#ifndef ALIGNED_BUFFER_H
+#define ALIGNED_BUFFER_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace LinearAlgebra 
+{
+
+constexpr size_t kCacheLineBytes = 64;
+
+// Cache of freed cache-line aligned blocks, keyed by their rounded size.
+// Repeated jobs of the same shape (batch runs, engine scratch) then reuse
+// memory that is already mapped instead of faulting in fresh pages and
+// clearing them. Thread-safe; blocks beyond maxCachedBytes are freed.
+class BufferPool 
+{
+public:
+    explicit BufferPool(size_t maxCachedBytes = size_t(1) << 30);
+    ~BufferPool();
+    
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+    
+    // Uninitialized block of at least `bytes`; give it back with release()
+    void* acquire(size_t bytes);
+    void release(void* block, size_t bytes);
+    
+    // Frees every cached block
+    void trim();
+    
+    size_t getCachedBytes() const;
+    
+    // Process-wide pool the engines take their scratch buffers from
+    static BufferPool& shared();
+    
+private:
+    static size_t roundUp(size_t bytes);
+    
+    const size_t maxCachedBytes;
+    mutable std::mutex mutex;
+    std::unordered_map<size_t, std::vector<void*>> cached;
+    size_t cachedBytes = 0;
+};
+
+enum class HugePages 
+{
+    None,          // ordinary 4 KiB pages from the heap
+    Transparent,   // 2 MiB aligned mapping with MADV_HUGEPAGE
+    Explicit       // MAP_HUGETLB from the reserved pool, else Transparent
+};
+
+enum class NumaPlacement 
+{
+    FirstTouch,    // each page lands on the node of the thread that first writes it
+    Interleave,    // pages round-robin over every online node
+    Preferred      // pages on numaNode while it has memory
+};
+
+// How a matrix or scratch buffer gets its memory. Huge pages and NUMA
+// placement need a dedicated mapping (Linux only; elsewhere they are
+// ignored), so such blocks bypass the pool and arrive zeroed by the kernel.
+struct AllocationPolicy 
+{
+    bool zeroFill = true;          // false when every element is written before it is read
+    BufferPool* pool = nullptr;    // recycle through this pool instead of the heap
+    HugePages hugePages = HugePages::None;
+    NumaPlacement numa = NumaPlacement::FirstTouch;
+    int numaNode = 0;              // target node of NumaPlacement::Preferred
+    
+    // Matrix only: with more than one thread, row tiles of firstTouchRows
+    // rows are first touched by the threads of a pool, so their pages spread
+    // over the nodes the engine's workers run on. Each worker zeroes its
+    // tile when zeroFill is set and otherwise writes one element per page.
+    size_t firstTouchThreads = 1;
+    size_t firstTouchRows = 128;
+};
+
+// Returns the block to its pool, its mapping, or the heap
+struct AlignedDelete 
+{
+    BufferPool* pool = nullptr;
+    size_t bytes = 0;
+    bool mapped = false;
+    size_t offset = 0;   // mapped: the block starts this far into the mapping
+    
+    void operator()(void* p) const;
+};
+
+// Array of trivially destructible T starting on a cache line
+template <typename T>
+using AlignedArray = std::unique_ptr<T[], AlignedDelete>;
+
+// Fills `deleter` with what it needs to give the block back
+void* allocateAlignedBytes(size_t bytes, const AllocationPolicy& policy, AlignedDelete& deleter);
+
+template <typename T>
+AlignedArray<T> allocateAligned(size_t count, const AllocationPolicy& policy = AllocationPolicy()) 
+{
+    static_assert(std::is_trivially_destructible_v<T>, "AlignedArray does not run destructors");
+    AlignedDelete deleter;
+    T* p = static_cast<T*>(allocateAlignedBytes(count * sizeof(T), policy, deleter));
+    if (policy.zeroFill && !deleter.mapped) 
+    {
+        std::uninitialized_value_construct_n(p, count);
+    }
+    return AlignedArray<T>(p, deleter);
+}
+
+// Leading dimension, in elements, for rows of `columns` elements: rounded up
+// to whole cache lines so every row starts aligned, plus one more line when
+// the row length is a multiple of 1 KiB. Such strides (the 1024, 2048 and
+// 4096 orders) map a column onto a handful of cache sets and make column
+// walks evict each other; the extra line spreads them over all sets.
+template <typename T>
+size_t paddedStride(size_t columns) 
+{
+    constexpr size_t kLine = kCacheLineBytes % sizeof(T) == 0 ? kCacheLineBytes / sizeof(T) : 1;
+    constexpr size_t kAliasingBytes = 1024;
+    
+    size_t stride = (columns + kLine - 1) / kLine * kLine;
+    if (stride != 0 && stride * sizeof(T) % kAliasingBytes == 0) 
+    {
+        stride += kLine;
+    }
+    return stride;
+}
+
+} // namespace LinearAlgebra
+
+#endif // ALIGNED_BUFFER_H
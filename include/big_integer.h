@@ -0,0 +1,72 @@
+#ifndef BIG_INTEGER_H
+#define BIG_INTEGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace LinearAlgebra 
+{
+
+// Arbitrary-precision signed integer for the exact determinant engines.
+// Sign and magnitude, with the magnitude stored as little-endian 32-bit limbs
+// and no leading zero limbs (zero has no limbs at all).
+class BigInteger 
+{
+public:
+    BigInteger() = default;
+    BigInteger(long long value);
+    
+    // value must be finite and integral
+    static BigInteger fromIntegral(long double value);
+    
+    bool isZero() const;
+    int sign() const;
+    size_t bitLength() const;
+    
+    BigInteger operator-() const;
+    BigInteger operator+(const BigInteger& other) const;
+    BigInteger operator-(const BigInteger& other) const;
+    BigInteger operator*(const BigInteger& other) const;
+    BigInteger operator/(const BigInteger& other) const;   // truncates toward zero
+    BigInteger operator%(const BigInteger& other) const;   // sign follows the dividend
+    
+    BigInteger& operator+=(const BigInteger& other);
+    BigInteger& operator-=(const BigInteger& other);
+    BigInteger& operator*=(const BigInteger& other);
+    
+    bool operator==(const BigInteger& other) const;
+    bool operator!=(const BigInteger& other) const;
+    bool operator<(const BigInteger& other) const;
+    
+    // Residue in [0, modulus)
+    uint64_t modulo(uint64_t modulus) const;
+    
+    bool fitsInt64() const;
+    long long toInt64() const;
+    
+    // |value| = mantissa * 2^exponent with mantissa in [0.5, 1) carrying the
+    // sign, so callers can take logs of numbers far outside long double range
+    long double toMantissa(long& exponent) const;
+    long double toLongDouble() const;
+    
+    std::string toString() const;
+    
+private:
+    using Limbs = std::vector<uint32_t>;
+    
+    static int compareMagnitude(const Limbs& a, const Limbs& b);
+    static Limbs addMagnitude(const Limbs& a, const Limbs& b);
+    static Limbs subtractMagnitude(const Limbs& a, const Limbs& b);
+    static Limbs multiplyMagnitude(const Limbs& a, const Limbs& b);
+    static Limbs divideMagnitude(const Limbs& a, const Limbs& b, Limbs* remainder);
+    static void trim(Limbs& limbs);
+    
+    Limbs limbs;
+    bool negative = false;
+};
+
+} // namespace LinearAlgebra
+
+#endif // BIG_INTEGER_H
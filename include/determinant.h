@@ -1,46 +1,311 @@
 #ifndef DETERMINANT_H
 #define DETERMINANT_H
 
+#include "aligned_buffer.h"
+#include <algorithm>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <vector>
 #include <cstddef>
 
 namespace LinearAlgebra 
 {
 
+class BigInteger;
+class ThreadPool;
+template <typename T> class FileMatrix;
+template <typename T> class TiledMatrix;
+
+// Non-owning window onto row-major storage: rows x cols entries, rows
+// `stride` elements apart. Copying a view copies four words, never the
+// entries; MatrixView<const T> is the read-only flavour. The storage must
+// outlive every view of it.
+template <typename T>
+class MatrixView 
+{
+private:
+    T* data;
+    size_t rows;
+    size_t cols;
+    size_t stride;
+    
+public:
+    MatrixView(T* data, size_t rows, size_t cols, size_t stride) 
+        : data(data), rows(rows), cols(cols), stride(stride) 
+    {
+        if (stride < cols) 
+        {
+            throw std::invalid_argument("View stride is smaller than its column count");
+        }
+    }
+    
+    // A mutable view converts to a read-only one
+    template <typename U, typename = std::enable_if_t<std::is_same_v<const U, T>>>
+    MatrixView(const MatrixView<U>& other) 
+        : data(other.getData()), rows(other.getRows()), cols(other.getCols()), stride(other.getStride()) 
+    {
+    }
+    
+    T& operator()(size_t i, size_t j) const { return data[i * stride + j]; }
+    
+    T* getData() const { return data; }
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+    size_t getStride() const { return stride; }
+    
+    // Order of a square view, which is all the engines accept
+    size_t getSize() const { return rows; }
+    bool isSquare() const { return rows == cols; }
+    
+    // Rows [row, row + count) x columns [col, col + width), same storage
+    MatrixView block(size_t row, size_t col, size_t count, size_t width) const 
+    {
+        if (row + count > rows || col + width > cols) 
+        {
+            throw std::out_of_range("Block exceeds the view");
+        }
+        return MatrixView(data + row * stride + col, count, width, stride);
+    }
+    
+    void swapRows(size_t i, size_t j) const 
+    {
+        if (i == j) return;
+        std::swap_ranges(data + i * stride, data + i * stride + cols, data + j * stride);
+    }
+};
+
+// Dense square matrix, row-major. T is float, double, long double or, where
+// the compiler has it, __float128; every engine is instantiated for each.
+// Rows are `stride` elements apart in a cache-line aligned buffer; the
+// padding past column size - 1 is never read by the engines.
+template <typename T = long double>
 class Matrix 
 {
 private:
-    std::unique_ptr<long double[]> data;
+    AlignedArray<T> data;
     size_t size;
+    size_t stride;
+    AllocationPolicy policy;   // copies are allocated the same way
+    bool integral = false;
     
     size_t index(size_t i, size_t j) const;
     
 public:
+    // Leading dimension from paddedStride: aligned rows, no aliasing strides.
+    // The policy can skip zero-filling and draw the buffer from a BufferPool
     Matrix(size_t n);
+    Matrix(size_t n, const AllocationPolicy& policy);
+    // Explicit leading dimension >= n; rows are aligned only when
+    // leadingDimension * sizeof(T) is a multiple of the cache line
+    Matrix(size_t n, size_t leadingDimension, const AllocationPolicy& policy = AllocationPolicy());
+    // Takes over a filled buffer of at least n * leadingDimension elements,
+    // such as a file mapping; the policy applies to copies
+    Matrix(AlignedArray<T> buffer, size_t n, size_t leadingDimension, const AllocationPolicy& policy = AllocationPolicy());
     Matrix(const Matrix& other);
     Matrix(Matrix&& other) noexcept;
     Matrix& operator=(const Matrix& other);
     Matrix& operator=(Matrix&& other) noexcept;
     ~Matrix() = default;
     
-    long double& operator()(size_t i, size_t j);
-    const long double& operator()(size_t i, size_t j) const;
+    using Scalar = T;
+    
+    T& operator()(size_t i, size_t j);
+    const T& operator()(size_t i, size_t j) const;
+    
+    T* getData();
+    const T* getData() const;
     
     size_t getSize() const;
+    // Elements between the starts of consecutive rows of getData()
+    size_t getStride() const;
+    
+    // Set by MatrixReader when every entry it read is an integer within the
+    // int64 range; describes the entries as read, not after factorization
+    bool isIntegral() const;
+    void setIntegral(bool value);
+    
     void swapRows(size_t i, size_t j);
     Matrix copy() const;
+    
+    // The whole matrix as a view; use block() on it for submatrices
+    MatrixView<T> view();
+    MatrixView<const T> view() const;
+};
+
+// Scratch space for the non-destructive determinant overloads: the input is
+// copied here and factored in place, so the caller's matrix is left as it
+// was. The buffer only ever grows and the thread pool is kept while the
+// thread count stays the same, so once a workspace has seen the largest
+// order of a loop, the unblocked, blocked and simd engines allocate nothing
+// on later calls.
+template <typename T = long double>
+class Workspace 
+{
+private:
+    AlignedArray<T> data;
+    size_t capacity = 0;
+    AllocationPolicy policy;
+    std::unique_ptr<ThreadPool> pool;
+    
+public:
+    explicit Workspace(const AllocationPolicy& policy = AllocationPolicy());
+    // Sized up front for matrices of order up to n
+    explicit Workspace(size_t n, const AllocationPolicy& policy = AllocationPolicy());
+    Workspace(Workspace&& other) noexcept;
+    Workspace& operator=(Workspace&& other) noexcept;
+    ~Workspace();
+    
+    // n x n view of the buffer with rows paddedStride<T>(n) apart, growing
+    // it first when too small; the contents are left over from earlier use
+    MatrixView<T> reserve(size_t n);
+    // Pool of `threads` threads, or nullptr for one thread
+    ThreadPool* getPool(size_t threads);
+    // Elements the buffer holds without growing
+    size_t getCapacity() const;
 };
 
 namespace DeterminantCalculator 
 {
-    long double calculateDeterminant(Matrix& matrix);
+    enum class Engine 
+    {
+        Unblocked,  // k-i-j elimination over the whole trailing submatrix
+        Blocked,    // panel factorization + tiled trailing update
+        Simd,       // double precision, AVX2/AVX-512 kernels picked at runtime
+        Tiled,      // tile task graph on a work-stealing pool
+        TileMajor,  // left-looking LU on a contiguous-tile copy (see TiledMatrix)
+        Recursive,  // cache-oblivious recursive column splitting (Toledo)
+        Adaptive,   // simd in double, redone in long double when the error estimate is too large
+        Bareiss,    // exact fraction-free elimination for integer matrices
+        Modular     // exact multi-modular elimination + CRT for integer matrices
+    };
+    
+    struct Options 
+    {
+        Engine engine = Engine::Unblocked;
+        size_t panelWidth = 64;   // columns factored per panel (blocked engine)
+        size_t tileSize = 128;    // row/column tile of the trailing update (blocked, tiled, tile-major engines)
+        size_t threads = 1;       // threads sharing the trailing update; pivoting stays serial
+        bool earlyTermination = true;   // modular engine: stop once the CRT result is stable
+        bool logicalPivoting = false;   // unblocked, blocked engines: record row swaps instead of moving rows
+        double adaptiveTolerance = 1e-6;    // adaptive engine: largest estimated relative error accepted from double
+    };
+    
+    // Sign and natural log of |det|, accumulated as mantissa and binary
+    // exponent so huge or tiny determinants neither overflow nor underflow
+    struct LogDeterminant 
+    {
+        int sign;             // -1 or +1; 0 for a singular matrix
+        long double logAbs;   // -infinity for a singular matrix
+    };
+    
+    // The LU engines work in the matrix's own scalar type, except simd,
+    // which always computes in double
+    template <typename T> T calculateDeterminant(Matrix<T>& matrix);
+    template <typename T> T calculateDeterminant(Matrix<T>& matrix, const Options& options);
+    // Also reports the row order of the factorization: row i of L and U is
+    // row permutation[i] of the input. With logicalPivoting the unblocked
+    // engine leaves that row where it was; the blocked engine leaves the
+    // panels left of the current one unswapped. Unblocked and blocked only.
+    template <typename T> T calculateDeterminant(Matrix<T>& matrix, const Options& options, std::vector<size_t>& permutation);
+    template <typename T> LogDeterminant logDeterminant(Matrix<T>& matrix, const Options& options = Options());
+    
+    // The same on a square view of caller-owned storage, factored in place
+    // without allocating a Matrix
+    template <typename T> T calculateDeterminant(MatrixView<T> matrix, const Options& options);
+    template <typename T> LogDeterminant logDeterminant(MatrixView<T> matrix, const Options& options = Options());
+    
+    // Non-destructive: the input is copied into the workspace and factored
+    // there, which with a reused workspace costs a copy but no allocation
+    template <typename T> T calculateDeterminant(const Matrix<T>& matrix, const Options& options, Workspace<T>& workspace);
+    template <typename T> T calculateDeterminant(MatrixView<const T> matrix, const Options& options, Workspace<T>& workspace);
+    template <typename T> LogDeterminant logDeterminant(const Matrix<T>& matrix, const Options& options, Workspace<T>& workspace);
+    template <typename T> LogDeterminant logDeterminant(MatrixView<const T> matrix, const Options& options, Workspace<T>& workspace);
+    
+    template <typename T> T calculateBlockedDeterminant(Matrix<T>& matrix, size_t panelWidth, size_t tileSize, size_t threads = 1);
+    template <typename T> double calculateSimdDeterminant(const Matrix<T>& matrix, size_t threads = 1);
+    template <typename T> T calculateTiledDeterminant(Matrix<T>& matrix, size_t tileSize, size_t threads = 1);
+    template <typename T> T calculateRecursiveDeterminant(Matrix<T>& matrix);
+    // Factors a tile-major matrix in place; the tile-major engine does the
+    // same on a TiledMatrix copy of a row-major one
+    template <typename T> T calculateTileMajorDeterminant(TiledMatrix<T>& matrix, size_t threads = 1);
+    
+    // Determinant of a matrix in a tile store (see FileMatrix), factored in
+    // place on disk tile column by tile column. Four tile columns, 4 n b
+    // elements, are in memory at a time; reads and write-backs run on
+    // background threads while the resident columns are computed.
+    template <typename T> T calculateOutOfCoreDeterminant(FileMatrix<T>& matrix, size_t threads = 1);
+    template <typename T> LogDeterminant logOutOfCoreDeterminant(FileMatrix<T>& matrix, size_t threads = 1);
+    
+    // Determinants of `count` n x n matrices (1 <= n <= 16) in one call. The
+    // batch is structure-of-arrays: entry (i, j) of matrix b sits at
+    // matrices[(i * n + j) * count + b], so consecutive matrices fill the
+    // lanes of one SIMD register and are eliminated side by side, each with
+    // its own partial pivoting. Double precision, no allocation per matrix.
+    void calculateBatchDeterminants(const double* matrices, size_t n, size_t count, double* determinants, size_t threads = 1);
+    
+    // Exact determinant of an integer matrix; works in int64 with 128-bit
+    // products and escalates to BigInteger on overflow. Leaves matrix intact.
+    template <typename T> BigInteger calculateBareissDeterminant(const Matrix<T>& matrix);
+    template <typename T> BigInteger calculateBareissDeterminant(MatrixView<const T> matrix);
+    
+    // Exact determinant from det(A) mod p for random 62-bit primes p, one
+    // prime per thread, combined with the Chinese Remainder Theorem. Stops
+    // once the primes cover Hadamard's bound, or with earlyTermination once
+    // the reconstruction has survived further primes unchanged (Monte Carlo:
+    // correct except with negligible probability, whatever the input).
+    template <typename T> BigInteger calculateModularDeterminant(const Matrix<T>& matrix, size_t threads = 1, bool earlyTermination = true);
+    template <typename T> BigInteger calculateModularDeterminant(MatrixView<const T> matrix, size_t threads = 1, bool earlyTermination = true);
+    
+    // Exact determinant through the Bareiss or Modular engine, whichever
+    // options.engine names (Bareiss for any other engine)
+    template <typename T> BigInteger calculateExactDeterminant(const Matrix<T>& matrix, const Options& options);
+    template <typename T> BigInteger calculateExactDeterminant(MatrixView<const T> matrix, const Options& options);
+    
+    const char* engineName(Engine engine);
+    Engine parseEngine(const std::string& name);
 }
 
 namespace MatrixReader 
 {
-    Matrix readFromFile(const std::string& filename);
-    Matrix readFromUserInput();
+    // Entries are parsed as T (as long double for __float128). Every entry
+    // is written, so the buffer is never zero-filled whatever the policy says.
+    // The file is read once, front to back, so it may also be a pipe or a
+    // FIFO; "-" reads standard input. With threads > 1 a regular file is
+    // parsed in newline-aligned chunks on that many threads, giving the
+    // same matrix. Binary matrix and .npy files are recognized by their
+    // magic and go to readBinary and readNumpy.
+    template <typename T = long double> Matrix<T> readFromFile(const std::string& filename, const AllocationPolicy& policy = AllocationPolicy(), 
+                                                               size_t threads = 1);
+    
+    // Binary matrix file (see MatrixWriter::writeBinary) mapped copy-on-write
+    // straight into the Matrix: nothing is parsed or copied, pages are read
+    // on first touch and the engines' in-place writes never reach the file.
+    // A file of another scalar type is converted into a buffer from policy.
+    template <typename T = long double> Matrix<T> readBinary(const std::string& filename, const AllocationPolicy& policy = AllocationPolicy());
+    // True for a regular file that starts like a binary matrix file
+    bool isBinary(const std::string& filename);
+    
+    // NumPy .npy file holding a square float32 or float64 array, in C or
+    // Fortran order. A C-order array of T whose data starts on a cache line
+    // is mapped copy-on-write like readBinary, with leading dimension n;
+    // anything else is converted, transposed for Fortran order, into a
+    // buffer from policy.
+    template <typename T = long double> Matrix<T> readNumpy(const std::string& filename, const AllocationPolicy& policy = AllocationPolicy());
+    // True for a regular file that starts with the .npy magic
+    bool isNumpy(const std::string& filename);
+    template <typename T = long double> Matrix<T> readFromUserInput(const AllocationPolicy& policy = AllocationPolicy());
+}
+
+namespace MatrixWriter 
+{
+    // Binary matrix file: a 64-byte header (magic, version, scalar type,
+    // layout, order, stride, integral flag) and then the rows, row-major,
+    // paddedStride<T>(n) elements apart, so the data starts and every row
+    // stays on a cache line boundary when the file is mapped
+    template <typename T> void writeBinary(const std::string& filename, const Matrix<T>& matrix);
+    template <typename T> void writeBinary(const std::string& filename, MatrixView<const T> matrix, bool integral = false);
 }
 
 void printUsage(const std::string& programName);
@@ -0,0 +1,66 @@
+#ifndef FILE_MATRIX_H
+#define FILE_MATRIX_H
+
+#include "determinant.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace LinearAlgebra 
+{
+
+// Square matrix kept in a binary tile store on disk, for orders whose
+// entries do not fit in memory. The file is a 64-byte header followed by
+// b x b tiles, each row-major, stored tile column by tile column: tiles
+// (0, j), (1, j), ... of tile column j are adjacent, so the lower part of a
+// tile column is one contiguous read. Edge tiles are padded with zeros.
+// Tiles move with explicit positioned reads and writes, which lets the
+// out-of-core engine decide what is resident and prefetch ahead of use.
+template <typename T = long double>
+class FileMatrix 
+{
+public:
+    // New store of order n with every entry zero
+    static FileMatrix create(const std::string& path, size_t n, size_t tileSize);
+    // Existing store; throws when it was written for another element type
+    static FileMatrix open(const std::string& path);
+    // Store holding a copy of an in-memory matrix
+    static FileMatrix fromMatrix(const std::string& path, MatrixView<const T> matrix, size_t tileSize);
+    // Store built from a text matrix (the MatrixReader format, a pipe
+    // included) one row tile at a time, so only tileSize rows are ever in
+    // memory
+    static FileMatrix importText(const std::string& textPath, const std::string& path, size_t tileSize);
+    
+    FileMatrix(FileMatrix&& other) noexcept;
+    FileMatrix& operator=(FileMatrix&& other) noexcept;
+    FileMatrix(const FileMatrix&) = delete;
+    FileMatrix& operator=(const FileMatrix&) = delete;
+    ~FileMatrix();
+    
+    size_t getSize() const;
+    size_t getTileSize() const;
+    size_t getTileCount() const;
+    
+    // Tiles [firstTile, getTileCount()) of tile column `column`, as a
+    // ((count * b) x b) row-major block with leading dimension b
+    void readTiles(size_t column, size_t firstTile, T* out) const;
+    void writeTiles(size_t column, size_t firstTile, const T* in);
+    
+    void readTile(size_t row, size_t column, T* out) const;
+    void writeTile(size_t row, size_t column, const T* in);
+    
+private:
+    FileMatrix(int fd, size_t size, size_t tileSize);
+    
+    uint64_t offset(size_t row, size_t column) const;
+    void transfer(uint64_t offset, size_t bytes, void* buffer, bool write) const;
+    
+    int fd = -1;
+    size_t size = 0;
+    size_t tileSize = 0;
+    size_t tiles = 0;
+};
+
+} // namespace LinearAlgebra
+
+#endif // FILE_MATRIX_H
@@ -0,0 +1,153 @@
+#ifndef FIXED_MATRIX_H
+#define FIXED_MATRIX_H
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace LinearAlgebra 
+{
+
+namespace FixedMatrixDetail 
+{
+    template <typename T>
+    constexpr T magnitude(T value) 
+    {
+        return value < T(0) ? -value : value;
+    }
+    
+    // Step K of partial-pivoting elimination; false once the matrix is singular
+    template <size_t N, size_t K, typename T>
+    constexpr bool eliminationStep(std::array<T, N * N>& m, T& det) 
+    {
+        // Selects rather than branches: pivot rows of real data are unpredictable
+        size_t pivot_row = K;
+        T best = magnitude(m[K * N + K]);
+        for (size_t i = K + 1; i < N; ++i) 
+        {
+            const T value = magnitude(m[i * N + K]);
+            pivot_row = value > best ? i : pivot_row;
+            best = value > best ? value : best;
+        }
+        
+        if (best == T(0)) 
+        {
+            det = T(0);
+            return false;
+        }
+        
+        for (size_t j = K; j < N; ++j) 
+        {
+            std::swap(m[K * N + j], m[pivot_row * N + j]);
+        }
+        det = pivot_row != K ? -det : det;
+        
+        const T pivot = m[K * N + K];
+        det *= pivot;
+        
+        for (size_t i = K + 1; i < N; ++i) 
+        {
+            const T factor = m[i * N + K] / pivot;
+            for (size_t j = K + 1; j < N; ++j) 
+            {
+                m[i * N + j] -= factor * m[K * N + j];
+            }
+        }
+        return true;
+    }
+    
+    template <size_t N, typename T, size_t... K>
+    constexpr T eliminate(std::array<T, N * N> m, std::index_sequence<K...>) 
+    {
+        T det = T(1);
+        (eliminationStep<N, K>(m, det) && ...);
+        return det;
+    }
+}
+
+// Square matrix whose order is known at compile time. Storage is an inline
+// row-major array, with no heap allocation, no stored size and no index
+// helper, so small determinants inline into the caller's loop and also work
+// in constant expressions.
+//
+// Orders 1-3 use the closed forms and 4 uses Laplace expansion over 2x2
+// minors. Orders 5-8 run partial-pivoting elimination with one unrolled step
+// per column. Only an exactly zero pivot counts as singular: unlike the
+// runtime engines there is no 1e-15 cutoff, so tiny orientation
+// determinants keep their sign.
+template <size_t N, typename T = long double>
+class FixedMatrix 
+{
+    static_assert(N >= 1 && N <= 8, "FixedMatrix covers orders 1 to 8; use Matrix beyond that");
+    
+private:
+    std::array<T, N * N> data{};
+    
+public:
+    constexpr FixedMatrix() = default;
+    
+    // Entries in row-major order: FixedMatrix<2>(a, b, c, d) is [[a, b], [c, d]]
+    template <typename... Values>
+        requires (sizeof...(Values) == N * N && (std::convertible_to<Values, T> && ...))
+    constexpr FixedMatrix(Values... values) : data{ static_cast<T>(values)... } 
+    {
+    }
+    
+    constexpr T& operator()(size_t i, size_t j) { return data[i * N + j]; }
+    constexpr const T& operator()(size_t i, size_t j) const { return data[i * N + j]; }
+    
+    constexpr T* getData() { return data.data(); }
+    constexpr const T* getData() const { return data.data(); }
+    
+    static constexpr size_t getSize() { return N; }
+    
+    constexpr T determinant() const 
+    {
+        const auto& a = data;
+        
+        if constexpr (N == 1) 
+        {
+            return a[0];
+        }
+        else if constexpr (N == 2) 
+        {
+            return a[0] * a[3] - a[1] * a[2];
+        }
+        else if constexpr (N == 3) 
+        {
+            return a[0] * (a[4] * a[8] - a[5] * a[7])
+                 - a[1] * (a[3] * a[8] - a[5] * a[6])
+                 + a[2] * (a[3] * a[7] - a[4] * a[6]);
+        }
+        else if constexpr (N == 4) 
+        {
+            // 2x2 minors of rows 0-1 paired with complementary minors of rows 2-3
+            const T s0 = a[0] * a[5] - a[4] * a[1];
+            const T s1 = a[0] * a[6] - a[4] * a[2];
+            const T s2 = a[0] * a[7] - a[4] * a[3];
+            const T s3 = a[1] * a[6] - a[5] * a[2];
+            const T s4 = a[1] * a[7] - a[5] * a[3];
+            const T s5 = a[2] * a[7] - a[6] * a[3];
+            
+            const T c5 = a[10] * a[15] - a[14] * a[11];
+            const T c4 = a[9] * a[15] - a[13] * a[11];
+            const T c3 = a[9] * a[14] - a[13] * a[10];
+            const T c2 = a[8] * a[15] - a[12] * a[11];
+            const T c1 = a[8] * a[14] - a[12] * a[10];
+            const T c0 = a[8] * a[13] - a[12] * a[9];
+            
+            return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        }
+        else 
+        {
+            static_assert(!std::is_integral_v<T>, "Orders above 4 divide; use a floating-point T");
+            return FixedMatrixDetail::eliminate<N>(data, std::make_index_sequence<N>());
+        }
+    }
+};
+
+} // namespace LinearAlgebra
+
+#endif // FIXED_MATRIX_H
@@ -0,0 +1,46 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <cstddef>
+
+namespace LinearAlgebra 
+{
+
+namespace Simd 
+{
+    // Largest order the batched determinant kernel accepts
+    constexpr size_t kBatchMaxOrder = 16;
+    
+    // Double-precision kernels of the SIMD engine. Every instruction set gets
+    // its own table, built from the same source with different compiler flags;
+    // kernels() picks the widest one the running CPU supports.
+    struct KernelTable 
+    {
+        const char* name;
+        
+        // Index of the first element of x[0..count) with the largest magnitude
+        size_t (*findPivot)(const double* x, size_t count);
+        
+        // y[0..count) -= alpha * x[0..count)
+        void (*axpy)(double* y, const double* x, double alpha, size_t count);
+        
+        // x[0..count) *= alpha
+        void (*scale)(double* x, double alpha, size_t count);
+        
+        // out[b] = det of the n x n matrix b < count whose entry e = i * n + j
+        // is matrices[e * stride + b]; n <= kBatchMaxOrder
+        void (*batchDeterminant)(const double* matrices, size_t n, size_t stride, size_t count, double* out);
+        
+        // Number of bytes of data[0..count) equal to byte (row boundaries of
+        // the parallel text reader)
+        size_t (*countByte)(const char* data, size_t count, char byte);
+    };
+    
+    // Selected once per process. Setting HWMX_SIMD=scalar|avx2|avx512 caps the
+    // choice, which is handy for benchmarking the narrower paths.
+    const KernelTable& kernels();
+}
+
+} // namespace LinearAlgebra
+
+#endif // SIMD_KERNELS_H
@@ -0,0 +1,56 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LinearAlgebra 
+{
+
+// Fixed set of worker threads for fork-join loops. The calling thread takes
+// part in every loop, so a pool of N threads starts N - 1 workers.
+class ThreadPool 
+{
+public:
+    // body(chunk, worker): worker is in [0, getThreadCount()), 0 is the caller
+    using ChunkBody = std::function<void(size_t, size_t)>;
+    
+    explicit ThreadPool(size_t threads);
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    size_t getThreadCount() const;
+    
+    // Runs body for every chunk in [0, chunks) and returns once all are done.
+    // Chunks are handed out dynamically; the first exception is rethrown here.
+    void parallelFor(size_t chunks, const ChunkBody& body);
+    
+private:
+    void workerLoop(size_t worker);
+    void runChunks(size_t worker);
+    
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    
+    const ChunkBody* job = nullptr;
+    size_t jobChunks = 0;
+    std::atomic<size_t> nextChunk{0};
+    size_t generation = 0;
+    size_t busy = 0;
+    bool stopping = false;
+    std::exception_ptr failure;
+};
+
+} // namespace LinearAlgebra
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,48 @@
+#ifndef TILED_MATRIX_H
+#define TILED_MATRIX_H
+
+#include "determinant.h"
+#include <cstddef>
+
+namespace LinearAlgebra 
+{
+
+// Square matrix stored tile-major: every b x b tile is contiguous and
+// row-major, and the tiles of a tile column follow each other, the same
+// arrangement as the FileMatrix tile store. A tile column is then one
+// (nt * b) x b block with leading dimension b, so the pivot search and the
+// tile updates of the tile-major engine stream through contiguous memory
+// instead of striding across whole rows. Edge tiles are padded with zeros.
+template <typename T = long double>
+class TiledMatrix 
+{
+private:
+    AlignedArray<T> data;
+    size_t size;
+    size_t tileSize;
+    size_t tiles;
+    
+public:
+    TiledMatrix(size_t n, size_t tileSize, const AllocationPolicy& policy = AllocationPolicy());
+    
+    // Conversion from and to the row-major layout, one tile row at a time
+    static TiledMatrix fromRowMajor(MatrixView<const T> matrix, size_t tileSize,
+                                    const AllocationPolicy& policy = AllocationPolicy());
+    void toRowMajor(MatrixView<T> matrix) const;
+    Matrix<T> toMatrix() const;
+    
+    T& operator()(size_t i, size_t j);
+    const T& operator()(size_t i, size_t j) const;
+    
+    // First element of tile (row, column)
+    T* tile(size_t row, size_t column);
+    const T* tile(size_t row, size_t column) const;
+    
+    size_t getSize() const;
+    size_t getTileSize() const;
+    size_t getTileCount() const;
+};
+
+} // namespace LinearAlgebra
+
+#endif // TILED_MATRIX_H
@@ -0,0 +1,67 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LinearAlgebra 
+{
+
+// Task pool for dataflow scheduling. Every thread owns a deque: tasks it
+// spawns go to the back and are popped from the back (depth first, good
+// locality), idle threads steal from the front of the other deques. The
+// thread calling wait() acts as worker 0 until all tasks have finished.
+class WorkStealingPool 
+{
+public:
+    using Task = std::function<void()>;
+    
+    explicit WorkStealingPool(size_t threads);
+    ~WorkStealingPool();
+    
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    
+    size_t getThreadCount() const;
+    
+    // Queue a task. Called from a task it lands on the running worker's deque.
+    void spawn(Task task);
+    
+    // Run tasks until everything spawned so far, including tasks spawned by
+    // tasks, has completed. The first exception thrown by a task is rethrown.
+    void wait();
+    
+private:
+    struct Queue 
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    
+    bool tryRunOne(size_t worker);
+    void workerLoop(size_t worker);
+    
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    
+    std::atomic<size_t> pending{0};   // spawned but not finished
+    std::atomic<size_t> queued{0};    // sitting in a deque
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    bool stopping = false;
+    
+    std::mutex failureMutex;
+    std::exception_ptr failure;
+};
+
+} // namespace LinearAlgebra
+
+#endif // WORK_STEALING_POOL_H
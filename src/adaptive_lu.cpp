@@ -0,0 +1,48 @@
+#include "determinant.h"
+#include "engines.h"
+#include "scalar_traits.h"
+#include <algorithm>
+#include <type_traits>
+
+namespace LinearAlgebra 
+{
+
+// Most inputs are well conditioned and double is accurate enough for them,
+// so the double simd engine runs first and estimates its relative error
+// from the factors, about u kappa(A) times the pivot growth. Only when
+// that estimate exceeds the tolerance is the matrix factored again, by the
+// blocked engine in long double (in T when T is wider still); the input is
+// left intact until then.
+template <typename T>
+PivotProduct<T> Engines::adaptive(MatrixView<T> matrix, const DeterminantCalculator::Options& options, ThreadPool* pool) 
+{
+    double estimate = 0.0;
+    PivotProduct<T> product = simd<T>(matrix, pool, &estimate);
+    if (estimate <= options.adaptiveTolerance) 
+    {
+        return product;
+    }
+    
+    using Escalated = typename ScalarTraits<T>::Escalated;
+    if constexpr (std::is_same_v<T, Escalated>) 
+    {
+        return blocked(matrix, options.panelWidth, options.tileSize, pool, false, nullptr);
+    }
+    else 
+    {
+        const size_t n = matrix.getSize();
+        Matrix<Escalated> wide(n, AllocationPolicy{ false, &BufferPool::shared() });
+        for (size_t i = 0; i < n; ++i) 
+        {
+            std::copy(&matrix(i, 0), &matrix(i, 0) + n, &wide(i, 0));
+        }
+        return blocked(wide.view(), options.panelWidth, options.tileSize, pool, false, nullptr).template as<T>();
+    }
+}
+
+#define HWMX_INSTANTIATE(T) \
+    template PivotProduct<T> Engines::adaptive(MatrixView<T>, const DeterminantCalculator::Options&, ThreadPool*);
+HWMX_FOR_EACH_SCALAR(HWMX_INSTANTIATE)
+#undef HWMX_INSTANTIATE
+
+} // namespace LinearAlgebra
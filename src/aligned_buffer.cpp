@@ -0,0 +1,253 @@
+#include "aligned_buffer.h"
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <string>
+
+#include <sys/mman.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace LinearAlgebra 
+{
+
+namespace 
+{
+
+// Pool size classes are whole pages, so near-equal requests share blocks
+constexpr size_t kPoolGranule = 4096;
+
+void* allocateFromHeap(size_t bytes) 
+{ 
+    return ::operator new[](bytes, std::align_val_t(kCacheLineBytes)); 
+}
+
+void freeToHeap(void* block) 
+{ 
+    ::operator delete[](block, std::align_val_t(kCacheLineBytes)); 
+}
+
+#ifdef __linux__
+
+constexpr size_t kHugePageBytes = size_t(2) << 20;
+
+// Linux memory policy modes, as in <linux/mempolicy.h>
+constexpr int kMpolPreferred = 1;
+constexpr int kMpolInterleave = 3;
+
+// Online NUMA nodes as a bit mask; "0-3,6" style list from sysfs
+unsigned long onlineNodes() 
+{
+    std::ifstream file("/sys/devices/system/node/online");
+    std::string list;
+    if (!(file >> list)) return 1;
+    
+    unsigned long mask = 0;
+    size_t pos = 0;
+    while (pos < list.size()) 
+    {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos) end = list.size();
+        const std::string range = list.substr(pos, end - pos);
+        const size_t dash = range.find('-');
+        const unsigned long first = std::stoul(range.substr(0, dash));
+        const unsigned long last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+        for (unsigned long node = first; node <= last && node < 8 * sizeof(mask); ++node) 
+        {
+            mask |= 1ul << node;
+        }
+        pos = end + 1;
+    }
+    return mask ? mask : 1;
+}
+
+// Placement is a hint: a kernel without NUMA support just ignores it
+void applyPlacement(void* block, size_t bytes, const AllocationPolicy& policy) 
+{
+    unsigned long mask = 0;
+    int mode = 0;
+    
+    if (policy.numa == NumaPlacement::Interleave) 
+    {
+        mode = kMpolInterleave;
+        mask = onlineNodes();
+    }
+    else if (policy.numa == NumaPlacement::Preferred && policy.numaNode >= 0 && policy.numaNode < int(8 * sizeof(mask))) 
+    {
+        mode = kMpolPreferred;
+        mask = 1ul << policy.numaNode;
+    }
+    else 
+    {
+        return;
+    }
+    
+    syscall(SYS_mbind, block, bytes, mode, &mask, 8 * sizeof(mask) + 1, 0u);
+}
+
+void* mapWithPolicy(size_t bytes, const AllocationPolicy& policy, size_t& mappedBytes) 
+{
+    const size_t length = (bytes + kHugePageBytes - 1) / kHugePageBytes * kHugePageBytes;
+    
+    if (policy.hugePages == HugePages::Explicit) 
+    {
+        void* block = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (block != MAP_FAILED) 
+        {
+            applyPlacement(block, length, policy);
+            mappedBytes = length;
+            return block;
+        }
+    }
+    
+    // Over-map by one huge page and trim, so the block starts on a 2 MiB
+    // boundary and every one of its huge-page frames can be backed by THP
+    const size_t padded = length + kHugePageBytes;
+    void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) 
+    {
+        throw std::bad_alloc();
+    }
+    
+    char* start = static_cast<char*>(raw);
+    char* aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(start) + kHugePageBytes - 1) & ~(kHugePageBytes - 1));
+    if (aligned > start) 
+    {
+        munmap(start, aligned - start);
+    }
+    const size_t tail = start + padded - (aligned + length);
+    if (tail > 0) 
+    {
+        munmap(aligned + length, tail);
+    }
+    
+    if (policy.hugePages != HugePages::None) 
+    {
+        madvise(aligned, length, MADV_HUGEPAGE);
+    }
+    applyPlacement(aligned, length, policy);
+    mappedBytes = length;
+    return aligned;
+}
+
+bool needsMapping(const AllocationPolicy& policy) 
+{ 
+    return policy.hugePages != HugePages::None || policy.numa != NumaPlacement::FirstTouch; 
+}
+
+#endif // __linux__
+
+} // namespace
+
+BufferPool::BufferPool(size_t maxCachedBytes) : maxCachedBytes(maxCachedBytes) 
+{
+}
+
+BufferPool::~BufferPool() 
+{ 
+    trim(); 
+}
+
+size_t BufferPool::roundUp(size_t bytes) 
+{ 
+    return (bytes + kPoolGranule - 1) / kPoolGranule * kPoolGranule; 
+}
+
+void* BufferPool::acquire(size_t bytes) 
+{
+    const size_t rounded = roundUp(bytes);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = cached.find(rounded);
+        if (it != cached.end() && !it->second.empty()) 
+        {
+            void* block = it->second.back();
+            it->second.pop_back();
+            cachedBytes -= rounded;
+            return block;
+        }
+    }
+    return allocateFromHeap(rounded);
+}
+
+void BufferPool::release(void* block, size_t bytes) 
+{
+    if (!block) return;
+    
+    const size_t rounded = roundUp(bytes);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cachedBytes + rounded <= maxCachedBytes) 
+        {
+            cached[rounded].push_back(block);
+            cachedBytes += rounded;
+            return;
+        }
+    }
+    freeToHeap(block);
+}
+
+void BufferPool::trim() 
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : cached) 
+    {
+        for (void* block : entry.second) 
+        {
+            freeToHeap(block);
+        }
+    }
+    cached.clear();
+    cachedBytes = 0;
+}
+
+size_t BufferPool::getCachedBytes() const 
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return cachedBytes;
+}
+
+BufferPool& BufferPool::shared() 
+{
+    static BufferPool pool(size_t(256) << 20);
+    return pool;
+}
+
+void* allocateAlignedBytes(size_t bytes, const AllocationPolicy& policy, AlignedDelete& deleter) 
+{
+#ifdef __linux__
+    if (needsMapping(policy) && bytes > 0) 
+    {
+        deleter = AlignedDelete{ nullptr, 0, true };
+        return mapWithPolicy(bytes, policy, deleter.bytes);
+    }
+#endif
+    
+    deleter = AlignedDelete{ policy.pool, bytes, false };
+    return policy.pool ? policy.pool->acquire(bytes) : allocateFromHeap(bytes);
+}
+
+void AlignedDelete::operator()(void* p) const 
+{
+    if (!p) return;
+    
+    if (mapped) 
+    {
+        munmap(static_cast<char*>(p) - offset, bytes);
+        return;
+    }
+    
+    if (pool) 
+    {
+        pool->release(p, bytes);
+    }
+    else 
+    {
+        freeToHeap(p);
+    }
+}
+
+} // namespace LinearAlgebra
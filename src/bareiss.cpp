@@ -0,0 +1,198 @@
+#include "determinant.h"
+#include "big_integer.h"
+#include "scalar_traits.h"
+#include <climits>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace LinearAlgebra 
+{
+
+namespace 
+{
+
+// Position in the elimination, so the 64-bit pass can hand its matrix over to
+// the big-integer pass exactly where it overflowed. row == 0 means step k has
+// not picked its pivot yet; every row being worked on is at least k + 1.
+struct BareissState 
+{
+    size_t k = 0;
+    size_t row = 0;
+    size_t col = 0;
+    bool negated = false;
+    bool singular = false;
+};
+
+// Fraction-free Gaussian elimination (Bareiss):
+//   m[i][j] = (m[i][j] * m[k][k] - m[i][k] * m[k][j]) / m[k-1][k-1]
+// Every division is exact and every intermediate is a minor of the input,
+// so the entries stay integers bounded by Hadamard's inequality.
+// Returns false when update() reports an overflow; state then points at the
+// entry that still has to be computed.
+template <typename Int, typename Update>
+bool eliminate(std::vector<Int>& m, size_t n, BareissState& state, Update update) 
+{
+    const Int one(1);
+    const Int zero(0);
+    
+    for (; state.k + 1 < n; ++state.k, state.row = 0) 
+    {
+        const size_t k = state.k;
+        
+        if (state.row == 0) 
+        {
+            size_t pivot_row = k;
+            while (pivot_row < n && m[pivot_row * n + k] == zero) 
+            {
+                ++pivot_row;
+            }
+            
+            if (pivot_row == n) 
+            {
+                state.singular = true;
+                return true;
+            }
+            
+            if (pivot_row != k) 
+            {
+                for (size_t j = k; j < n; ++j) 
+                {
+                    std::swap(m[k * n + j], m[pivot_row * n + j]);
+                }
+                state.negated = !state.negated;
+            }
+            
+            state.row = k + 1;
+            state.col = k + 1;
+        }
+        
+        const Int& pivot = m[k * n + k];
+        const Int& previous = k == 0 ? one : m[(k - 1) * n + k - 1];
+        
+        for (; state.row < n; ++state.row, state.col = k + 1) 
+        {
+            const size_t i = state.row;
+            for (; state.col < n; ++state.col) 
+            {
+                const size_t j = state.col;
+                if (!update(m[i * n + j], pivot, m[i * n + k], m[k * n + j], previous)) 
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    
+    return true;
+}
+
+bool updateSmall(long long& target, long long pivot, long long below, long long right, long long previous) 
+{
+    const __int128 numerator = static_cast<__int128>(target) * pivot - static_cast<__int128>(below) * right;
+    const __int128 quotient = numerator / previous;
+    
+    if (quotient > LLONG_MAX || quotient < LLONG_MIN) 
+    {
+        return false;
+    }
+    
+    target = static_cast<long long>(quotient);
+    return true;
+}
+
+bool updateBig(BigInteger& target, const BigInteger& pivot, const BigInteger& below, const BigInteger& right, const BigInteger& previous) 
+{
+    target = (target * pivot - below * right) / previous;
+    return true;
+}
+
+template <typename Int>
+BigInteger finish(const std::vector<Int>& m, size_t n, const BareissState& state) 
+{
+    if (state.singular) return BigInteger(0);
+    const BigInteger det(m[n * n - 1]);
+    return state.negated ? -det : det;
+}
+
+bool fitsInt64(long double value) 
+{
+    // 2^63 is exact in long double; the range check is done before the cast
+    return value >= -9223372036854775808.0L && value < 9223372036854775808.0L;
+}
+
+} // namespace
+
+template <typename T>
+BigInteger DeterminantCalculator::calculateBareissDeterminant(MatrixView<const T> matrix) 
+{
+    if (!matrix.isSquare()) 
+    {
+        throw std::invalid_argument("Determinant of a non-square view");
+    }
+    
+    const size_t n = matrix.getSize();
+    
+    if (n == 0) return BigInteger(1);
+    
+    bool small = true;
+    for (size_t i = 0; i < n; ++i) 
+    {
+        for (size_t j = 0; j < n; ++j) 
+        {
+            const long double value = static_cast<long double>(matrix(i, j));
+            if (!std::isfinite(value) || std::trunc(value) != value) 
+            {
+                throw std::invalid_argument("Bareiss engine requires integer matrix entries");
+            }
+            small = small && fitsInt64(value);
+        }
+    }
+    
+    BareissState state;
+    
+    // 64-bit entries with 128-bit products cover most inputs; an entry whose
+    // new value leaves the int64 range sends the rest of the work to BigInteger
+    std::vector<long long> narrow;
+    if (small) 
+    {
+        narrow.resize(n * n);
+        for (size_t i = 0; i < n; ++i) 
+        {
+            for (size_t j = 0; j < n; ++j) 
+            {
+                narrow[i * n + j] = static_cast<long long>(matrix(i, j));
+            }
+        }
+        
+        if (eliminate(narrow, n, state, updateSmall)) 
+        {
+            return finish(narrow, n, state);
+        }
+    }
+    
+    std::vector<BigInteger> wide(n * n);
+    for (size_t i = 0; i < n * n; ++i) 
+    {
+        wide[i] = small ? BigInteger(narrow[i]) : BigInteger::fromIntegral(static_cast<long double>(matrix(i / n, i % n)));
+    }
+    narrow.clear();
+    
+    eliminate(wide, n, state, updateBig);
+    return finish(wide, n, state);
+}
+
+template <typename T>
+BigInteger DeterminantCalculator::calculateBareissDeterminant(const Matrix<T>& matrix) 
+{ 
+    return calculateBareissDeterminant(matrix.view()); 
+}
+
+#define HWMX_INSTANTIATE(T) \
+    template BigInteger DeterminantCalculator::calculateBareissDeterminant(MatrixView<const T>); \
+    template BigInteger DeterminantCalculator::calculateBareissDeterminant(const Matrix<T>&);
+HWMX_FOR_EACH_SCALAR(HWMX_INSTANTIATE)
+#undef HWMX_INSTANTIATE
+
+} // namespace LinearAlgebra
@@ -0,0 +1,44 @@
+#include "determinant.h"
+#include "simd_kernels.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace LinearAlgebra 
+{
+
+namespace 
+{
+
+// Matrices per thread chunk; a multiple of every kernel's lane count
+constexpr size_t kBatchChunk = 4096;
+
+} // namespace
+
+void DeterminantCalculator::calculateBatchDeterminants(const double* matrices, size_t n, size_t count, double* determinants, size_t threads) 
+{
+    if (n == 0 || n > Simd::kBatchMaxOrder) 
+    {
+        throw std::invalid_argument("Batched determinants support orders 1 to " + std::to_string(Simd::kBatchMaxOrder));
+    }
+    if (count == 0) return;
+    
+    const Simd::KernelTable& simd = Simd::kernels();
+    const size_t chunks = (count + kBatchChunk - 1) / kBatchChunk;
+    
+    if (threads <= 1 || chunks == 1) 
+    {
+        simd.batchDeterminant(matrices, n, count, count, determinants);
+        return;
+    }
+    
+    ThreadPool pool(std::min(threads, chunks));
+    pool.parallelFor(chunks, [&](size_t chunk, size_t) 
+    {
+        const size_t first = chunk * kBatchChunk;
+        const size_t length = std::min(kBatchChunk, count - first);
+        simd.batchDeterminant(matrices + first, n, count, length, determinants + first);
+    });
+}
+
+} // namespace LinearAlgebra
@@ -0,0 +1,441 @@
+#include "big_integer.h"
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cmath>
+#include <stdexcept>
+
+namespace LinearAlgebra 
+{
+
+BigInteger::BigInteger(long long value) 
+{
+    negative = value < 0;
+    // Negate in unsigned arithmetic so LLONG_MIN is handled too
+    uint64_t magnitude = negative ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    while (magnitude) 
+    {
+        limbs.push_back(static_cast<uint32_t>(magnitude));
+        magnitude >>= 32;
+    }
+}
+
+BigInteger BigInteger::fromIntegral(long double value) 
+{
+    if (!std::isfinite(value) || std::trunc(value) != value) 
+    {
+        throw std::invalid_argument("BigInteger::fromIntegral: value is not an integer");
+    }
+    
+    BigInteger result;
+    if (value == 0.0L) return result;
+    
+    // value = mantissa * 2^exponent with the 64 mantissa bits taken as an integer
+    int exponent = 0;
+    long double mantissa = std::frexp(std::fabs(value), &exponent);
+    uint64_t bits = static_cast<uint64_t>(std::ldexp(mantissa, 64));
+    int shift = exponent - 64;
+    
+    if (shift < 0) 
+    {
+        bits >>= -shift;
+        shift = 0;
+    }
+    
+    result.limbs.assign(static_cast<size_t>(shift) / 32, 0);
+    const unsigned bit_shift = static_cast<unsigned>(shift) % 32;
+    const unsigned __int128 wide = static_cast<unsigned __int128>(bits) << bit_shift;
+    result.limbs.push_back(static_cast<uint32_t>(wide));
+    result.limbs.push_back(static_cast<uint32_t>(wide >> 32));
+    result.limbs.push_back(static_cast<uint32_t>(wide >> 64));
+    trim(result.limbs);
+    result.negative = value < 0.0L;
+    return result;
+}
+
+bool BigInteger::isZero() const 
+{ 
+    return limbs.empty(); 
+}
+
+int BigInteger::sign() const 
+{
+    if (limbs.empty()) return 0;
+    return negative ? -1 : 1;
+}
+
+size_t BigInteger::bitLength() const 
+{
+    if (limbs.empty()) return 0;
+    return (limbs.size() - 1) * 32 + (32 - static_cast<size_t>(std::countl_zero(limbs.back())));
+}
+
+BigInteger BigInteger::operator-() const 
+{
+    BigInteger result = *this;
+    if (!result.limbs.empty()) result.negative = !negative;
+    return result;
+}
+
+BigInteger BigInteger::operator+(const BigInteger& other) const 
+{
+    BigInteger result;
+    if (negative == other.negative) 
+    {
+        result.limbs = addMagnitude(limbs, other.limbs);
+        result.negative = negative;
+    }
+    else if (compareMagnitude(limbs, other.limbs) >= 0) 
+    {
+        result.limbs = subtractMagnitude(limbs, other.limbs);
+        result.negative = negative;
+    }
+    else 
+    {
+        result.limbs = subtractMagnitude(other.limbs, limbs);
+        result.negative = other.negative;
+    }
+    if (result.limbs.empty()) result.negative = false;
+    return result;
+}
+
+BigInteger BigInteger::operator-(const BigInteger& other) const 
+{ 
+    return *this + (-other); 
+}
+
+BigInteger BigInteger::operator*(const BigInteger& other) const 
+{
+    BigInteger result;
+    result.limbs = multiplyMagnitude(limbs, other.limbs);
+    result.negative = !result.limbs.empty() && negative != other.negative;
+    return result;
+}
+
+BigInteger BigInteger::operator/(const BigInteger& other) const 
+{
+    BigInteger result;
+    result.limbs = divideMagnitude(limbs, other.limbs, nullptr);
+    result.negative = !result.limbs.empty() && negative != other.negative;
+    return result;
+}
+
+BigInteger BigInteger::operator%(const BigInteger& other) const 
+{
+    BigInteger result;
+    divideMagnitude(limbs, other.limbs, &result.limbs);
+    result.negative = !result.limbs.empty() && negative;
+    return result;
+}
+
+BigInteger& BigInteger::operator+=(const BigInteger& other) 
+{ 
+    return *this = *this + other; 
+}
+
+BigInteger& BigInteger::operator-=(const BigInteger& other) 
+{ 
+    return *this = *this - other; 
+}
+
+BigInteger& BigInteger::operator*=(const BigInteger& other) 
+{ 
+    return *this = *this * other; 
+}
+
+bool BigInteger::operator==(const BigInteger& other) const 
+{ 
+    return negative == other.negative && limbs == other.limbs; 
+}
+
+bool BigInteger::operator!=(const BigInteger& other) const 
+{ 
+    return !(*this == other); 
+}
+
+bool BigInteger::operator<(const BigInteger& other) const 
+{
+    if (negative != other.negative) return negative;
+    const int magnitude = compareMagnitude(limbs, other.limbs);
+    return negative ? magnitude > 0 : magnitude < 0;
+}
+
+uint64_t BigInteger::modulo(uint64_t modulus) const 
+{
+    if (modulus == 0) 
+    {
+        throw std::domain_error("BigInteger::modulo: zero modulus");
+    }
+    
+    unsigned __int128 remainder = 0;
+    for (size_t i = limbs.size(); i-- > 0;) 
+    {
+        remainder = ((remainder << 32) | limbs[i]) % modulus;
+    }
+    
+    const uint64_t residue = static_cast<uint64_t>(remainder);
+    return negative && residue != 0 ? modulus - residue : residue;
+}
+
+bool BigInteger::fitsInt64() const 
+{
+    if (limbs.size() > 2) return false;
+    const uint64_t magnitude = limbs.empty() ? 0
+        : limbs.size() == 1 ? limbs[0]
+        : (static_cast<uint64_t>(limbs[1]) << 32) | limbs[0];
+    return negative ? magnitude <= static_cast<uint64_t>(LLONG_MAX) + 1 : magnitude <= static_cast<uint64_t>(LLONG_MAX);
+}
+
+long long BigInteger::toInt64() const 
+{
+    if (!fitsInt64()) 
+    {
+        throw std::overflow_error("BigInteger does not fit in 64 bits");
+    }
+    uint64_t magnitude = 0;
+    for (size_t i = limbs.size(); i-- > 0;) 
+    {
+        magnitude = (magnitude << 32) | limbs[i];
+    }
+    return negative ? static_cast<long long>(0 - magnitude) : static_cast<long long>(magnitude);
+}
+
+long double BigInteger::toMantissa(long& exponent) const 
+{
+    exponent = 0;
+    if (limbs.empty()) return 0.0L;
+    
+    // The top three limbs cover the 64-bit long double mantissa with room to spare
+    long double top = 0.0L;
+    const size_t used = std::min<size_t>(limbs.size(), 3);
+    for (size_t i = 0; i < used; ++i) 
+    {
+        top = top * 4294967296.0L + static_cast<long double>(limbs[limbs.size() - 1 - i]);
+    }
+    
+    int shift = 0;
+    const long double mantissa = std::frexp(top, &shift);
+    exponent = static_cast<long>(shift) + 32L * static_cast<long>(limbs.size() - used);
+    return negative ? -mantissa : mantissa;
+}
+
+long double BigInteger::toLongDouble() const 
+{
+    long exponent = 0;
+    const long double mantissa = toMantissa(exponent);
+    return std::ldexp(mantissa, static_cast<int>(std::min<long>(exponent, INT_MAX)));
+}
+
+std::string BigInteger::toString() const 
+{
+    if (limbs.empty()) return "0";
+    
+    // Peel off base-10^9 digits by short division
+    Limbs rest = limbs;
+    std::vector<uint32_t> chunks;
+    while (!rest.empty()) 
+    {
+        uint64_t remainder = 0;
+        for (size_t i = rest.size(); i-- > 0;) 
+        {
+            const uint64_t current = (remainder << 32) | rest[i];
+            rest[i] = static_cast<uint32_t>(current / 1000000000u);
+            remainder = current % 1000000000u;
+        }
+        trim(rest);
+        chunks.push_back(static_cast<uint32_t>(remainder));
+    }
+    
+    std::string text = negative ? "-" : "";
+    text += std::to_string(chunks.back());
+    for (size_t i = chunks.size() - 1; i-- > 0;) 
+    {
+        const std::string digits = std::to_string(chunks[i]);
+        text.append(9 - digits.size(), '0');
+        text += digits;
+    }
+    return text;
+}
+
+int BigInteger::compareMagnitude(const Limbs& a, const Limbs& b) 
+{
+    if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+    for (size_t i = a.size(); i-- > 0;) 
+    {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+BigInteger::Limbs BigInteger::addMagnitude(const Limbs& a, const Limbs& b) 
+{
+    const Limbs& longer = a.size() >= b.size() ? a : b;
+    const Limbs& shorter = a.size() >= b.size() ? b : a;
+    
+    Limbs result(longer.size() + 1);
+    uint64_t carry = 0;
+    for (size_t i = 0; i < longer.size(); ++i) 
+    {
+        const uint64_t sum = static_cast<uint64_t>(longer[i]) + (i < shorter.size() ? shorter[i] : 0) + carry;
+        result[i] = static_cast<uint32_t>(sum);
+        carry = sum >> 32;
+    }
+    result[longer.size()] = static_cast<uint32_t>(carry);
+    trim(result);
+    return result;
+}
+
+BigInteger::Limbs BigInteger::subtractMagnitude(const Limbs& a, const Limbs& b) 
+{
+    // Requires |a| >= |b|
+    Limbs result(a.size());
+    int64_t borrow = 0;
+    for (size_t i = 0; i < a.size(); ++i) 
+    {
+        int64_t diff = static_cast<int64_t>(a[i]) - (i < b.size() ? b[i] : 0) - borrow;
+        borrow = diff < 0 ? 1 : 0;
+        result[i] = static_cast<uint32_t>(diff + (borrow << 32));
+    }
+    trim(result);
+    return result;
+}
+
+BigInteger::Limbs BigInteger::multiplyMagnitude(const Limbs& a, const Limbs& b) 
+{
+    if (a.empty() || b.empty()) return {};
+    
+    Limbs result(a.size() + b.size(), 0);
+    for (size_t i = 0; i < a.size(); ++i) 
+    {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < b.size(); ++j) 
+        {
+            const uint64_t current = static_cast<uint64_t>(a[i]) * b[j] + result[i + j] + carry;
+            result[i + j] = static_cast<uint32_t>(current);
+            carry = current >> 32;
+        }
+        result[i + b.size()] = static_cast<uint32_t>(carry);
+    }
+    trim(result);
+    return result;
+}
+
+// Knuth's algorithm D (TAOCP 4.3.1) on 32-bit digits
+BigInteger::Limbs BigInteger::divideMagnitude(const Limbs& a, const Limbs& b, Limbs* remainder) 
+{
+    if (b.empty()) 
+    {
+        throw std::domain_error("BigInteger: division by zero");
+    }
+    
+    if (compareMagnitude(a, b) < 0) 
+    {
+        if (remainder) *remainder = a;
+        return {};
+    }
+    
+    if (b.size() == 1) 
+    {
+        Limbs quotient(a.size());
+        uint64_t rest = 0;
+        for (size_t i = a.size(); i-- > 0;) 
+        {
+            const uint64_t current = (rest << 32) | a[i];
+            quotient[i] = static_cast<uint32_t>(current / b[0]);
+            rest = current % b[0];
+        }
+        trim(quotient);
+        if (remainder) 
+        {
+            remainder->clear();
+            if (rest) remainder->push_back(static_cast<uint32_t>(rest));
+        }
+        return quotient;
+    }
+    
+    const size_t n = b.size();
+    const size_t m = a.size() - n;
+    const int shift = std::countl_zero(b.back());
+    
+    // Normalize so the divisor's top digit has its high bit set
+    Limbs v(n);
+    Limbs u(a.size() + 1);
+    for (size_t i = n - 1; i > 0; --i) 
+    {
+        v[i] = (b[i] << shift) | (shift ? static_cast<uint32_t>(static_cast<uint64_t>(b[i - 1]) >> (32 - shift)) : 0);
+    }
+    v[0] = b[0] << shift;
+    u[a.size()] = shift ? static_cast<uint32_t>(static_cast<uint64_t>(a.back()) >> (32 - shift)) : 0;
+    for (size_t i = a.size() - 1; i > 0; --i) 
+    {
+        u[i] = (a[i] << shift) | (shift ? static_cast<uint32_t>(static_cast<uint64_t>(a[i - 1]) >> (32 - shift)) : 0);
+    }
+    u[0] = a[0] << shift;
+    
+    const uint64_t base = 1ull << 32;
+    Limbs quotient(m + 1);
+    
+    for (size_t j = m + 1; j-- > 0;) 
+    {
+        const uint64_t numerator = (static_cast<uint64_t>(u[j + n]) << 32) | u[j + n - 1];
+        uint64_t qhat = numerator / v[n - 1];
+        uint64_t rhat = numerator % v[n - 1];
+        
+        while (qhat >= base || qhat * v[n - 2] > ((rhat << 32) | u[j + n - 2])) 
+        {
+            --qhat;
+            rhat += v[n - 1];
+            if (rhat >= base) break;
+        }
+        
+        // u[j..j+n] -= qhat * v
+        int64_t borrow = 0;
+        for (size_t i = 0; i < n; ++i) 
+        {
+            const uint64_t product = qhat * v[i];
+            const int64_t diff = static_cast<int64_t>(u[i + j]) - borrow - static_cast<int64_t>(product & 0xFFFFFFFFu);
+            u[i + j] = static_cast<uint32_t>(diff);
+            borrow = static_cast<int64_t>(product >> 32) - (diff >> 32);
+        }
+        const int64_t top = static_cast<int64_t>(u[j + n]) - borrow;
+        u[j + n] = static_cast<uint32_t>(top);
+        
+        if (top < 0) 
+        {
+            // qhat was one too large: add the divisor back
+            --qhat;
+            uint64_t carry = 0;
+            for (size_t i = 0; i < n; ++i) 
+            {
+                const uint64_t sum = static_cast<uint64_t>(u[i + j]) + v[i] + carry;
+                u[i + j] = static_cast<uint32_t>(sum);
+                carry = sum >> 32;
+            }
+            u[j + n] = static_cast<uint32_t>(u[j + n] + carry);
+        }
+        quotient[j] = static_cast<uint32_t>(qhat);
+    }
+    
+    if (remainder) 
+    {
+        remainder->assign(n, 0);
+        for (size_t i = 0; i < n; ++i) 
+        {
+            (*remainder)[i] = (u[i] >> shift) | (shift ? static_cast<uint32_t>(static_cast<uint64_t>(u[i + 1]) << (32 - shift)) : 0);
+        }
+        trim(*remainder);
+    }
+    
+    trim(quotient);
+    return quotient;
+}
+
+void BigInteger::trim(Limbs& limbs) 
+{
+    while (!limbs.empty() && limbs.back() == 0) 
+    {
+        limbs.pop_back();
+    }
+}
+
+} // namespace LinearAlgebra
@@ -0,0 +1,512 @@
+#include "determinant.h"
+#include "scalar_traits.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace LinearAlgebra 
+{
+
+namespace 
+{
+
+constexpr char kMagic[8] = { 'H', 'W', 'M', 'X', 'M', 'A', 'T', 'R' };
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kRowMajor = 0;
+constexpr size_t kHeaderBytes = 64;
+
+struct BinaryHeader 
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t scalar;        // scalarTag of the element type
+    uint32_t elementBytes;
+    uint32_t layout;        // kRowMajor is the only layout so far
+    uint64_t size;
+    uint64_t stride;        // elements between the starts of consecutive rows
+    uint8_t integral;       // Matrix::isIntegral of the written matrix
+    uint8_t reserved[23];
+};
+static_assert(sizeof(BinaryHeader) == kHeaderBytes, "Binary matrix header must be 64 bytes");
+
+// Size of the element type a scalarTag names, 0 for a tag it cannot name
+size_t scalarBytes(uint32_t tag) 
+{
+    switch (tag) 
+    {
+        case scalarTag<float>():       return sizeof(float);
+        case scalarTag<double>():      return sizeof(double);
+        case scalarTag<long double>(): return sizeof(long double);
+#ifdef __SIZEOF_FLOAT128__
+        case scalarTag<__float128>():  return sizeof(__float128);
+#endif
+        default:                       return 0;
+    }
+}
+
+constexpr char kNumpyMagic[6] = { '\x93', 'N', 'U', 'M', 'P', 'Y' };
+constexpr char kNativeOrder = __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ ? '<' : '>';
+
+// Read-only descriptor, closed on every exit
+class OpenFile 
+{
+public:
+    explicit OpenFile(const std::string& filename) : fd(::open(filename.c_str(), O_RDONLY)) 
+    {
+        if (fd < 0) 
+        {
+            throw std::runtime_error("Cannot open file: " + filename);
+        }
+    }
+    ~OpenFile() { ::close(fd); }
+    OpenFile(const OpenFile&) = delete;
+    OpenFile& operator=(const OpenFile&) = delete;
+    
+    int get() const { return fd; }
+    
+    uint64_t size() const 
+    {
+        struct stat status{};
+        return ::fstat(fd, &status) == 0 ? static_cast<uint64_t>(status.st_size) : 0;
+    }
+    
+    bool readAt(void* buffer, size_t bytes, uint64_t position) const 
+    {
+        return ::pread(fd, buffer, bytes, static_cast<off_t>(position)) == static_cast<ssize_t>(bytes);
+    }
+    
+private:
+    const int fd;
+};
+
+// Private, writable mapping of a whole file, unmapped on every exit until
+// adopt() hands it to a Matrix. The engines factor in place, and the pages
+// they write become copies instead of reaching the file.
+class Mapping 
+{
+public:
+    Mapping(const OpenFile& file, size_t bytes, const std::string& filename) : bytes(bytes) 
+    {
+        void* mapped = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, file.get(), 0);
+        if (mapped == MAP_FAILED) 
+        {
+            throw std::runtime_error("Cannot map file: " + filename + ": " + std::strerror(errno));
+        }
+        base = static_cast<char*>(mapped);
+    }
+    ~Mapping() 
+    {
+        if (base) munmap(base, bytes);
+    }
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+    
+    const char* at(size_t offset) const { return base + offset; }
+    
+    // Buffer whose deleter unmaps the whole file; offset is where it starts
+    template <typename T>
+    AlignedArray<T> adopt(size_t offset) 
+    {
+        AlignedArray<T> buffer(reinterpret_cast<T*>(base + offset), AlignedDelete{ nullptr, bytes, true, offset });
+        base = nullptr;
+        return buffer;
+    }
+    
+private:
+    char* base = nullptr;
+    const size_t bytes;
+};
+
+bool startsWith(const std::string& filename, const char* magic, size_t length) 
+{
+    struct stat status{};
+    if (::stat(filename.c_str(), &status) != 0 || !S_ISREG(status.st_mode)) return false;
+    
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    char prefix[8];
+    const bool match = ::pread(fd, prefix, length, 0) == static_cast<ssize_t>(length) && std::memcmp(prefix, magic, length) == 0;
+    ::close(fd);
+    return match;
+}
+
+AllocationPolicy unfilled(AllocationPolicy policy) 
+{
+    policy.zeroFill = false;
+    return policy;
+}
+
+template <typename S, typename T>
+void convertRows(const char* data, const BinaryHeader& header, Matrix<T>& matrix) 
+{
+    const S* source = reinterpret_cast<const S*>(data);
+    for (size_t i = 0; i < header.size; ++i) 
+    {
+        const S* row = source + i * header.stride;
+        for (size_t j = 0; j < header.size; ++j) 
+        {
+            matrix(i, j) = static_cast<T>(row[j]);
+        }
+    }
+}
+
+// What the .npy header dictionary says about the array
+struct NumpyHeader 
+{
+    char byteOrder = 0;
+    char kind = 0;
+    size_t elementBytes = 0;
+    bool fortranOrder = false;
+    std::vector<uint64_t> shape;
+    uint64_t dataOffset = 0;
+};
+
+// Text after `'key':` in the header, which is a Python dict literal such as
+// {'descr': '<f8', 'fortran_order': False, 'shape': (3, 3), }
+std::string_view dictValue(std::string_view dict, std::string_view key) 
+{
+    // The bare key, taken only where quotes enclose it
+    auto quoted = [&](size_t at) 
+    { 
+        return at > 0 && dict[at - 1] == '\'' && at + key.size() < dict.size() && dict[at + key.size()] == '\''; 
+    };
+    size_t pos = dict.find(key);
+    while (pos != std::string_view::npos && !quoted(pos)) 
+    {
+        pos = dict.find(key, pos + 1);
+    }
+    if (pos == std::string_view::npos) 
+    {
+        throw std::runtime_error("Invalid .npy header: no " + std::string(key));
+    }
+    pos = dict.find_first_not_of(" :", pos + key.size() + 1);
+    return pos == std::string_view::npos ? std::string_view() : dict.substr(pos);
+}
+
+NumpyHeader parseNumpyHeader(std::string_view dict) 
+{
+    NumpyHeader header;
+    
+    const std::string_view descr = dictValue(dict, "descr");
+    const size_t close = descr.find('\'', 1);
+    if (descr.empty() || descr[0] != '\'' || close == std::string_view::npos || close < 4) 
+    {
+        throw std::runtime_error("Invalid .npy header: descr");
+    }
+    header.byteOrder = descr[1];
+    header.kind = descr[2];
+    if (std::from_chars(descr.data() + 3, descr.data() + close, header.elementBytes).ec != std::errc()) 
+    {
+        throw std::runtime_error("Invalid .npy header: descr");
+    }
+    
+    header.fortranOrder = dictValue(dict, "fortran_order").substr(0, 4) == "True";
+    
+    const std::string_view shape = dictValue(dict, "shape");
+    const size_t end = shape.find(')');
+    if (shape.empty() || shape[0] != '(' || end == std::string_view::npos) 
+    {
+        throw std::runtime_error("Invalid .npy header: shape");
+    }
+    const char* cursor = shape.data() + 1;
+    const char* last = shape.data() + end;
+    while (cursor < last) 
+    {
+        while (cursor < last && (*cursor == ' ' || *cursor == ',')) ++cursor;
+        if (cursor == last) break;
+        uint64_t extent = 0;
+        const auto [next, ec] = std::from_chars(cursor, last, extent);
+        if (ec != std::errc()) 
+        {
+            throw std::runtime_error("Invalid .npy header: shape");
+        }
+        header.shape.push_back(extent);
+        cursor = next;
+    }
+    return header;
+}
+
+// Version 1.0 has a 16-bit header length, 2.0 and 3.0 a 32-bit one
+NumpyHeader readNumpyHeader(const OpenFile& file, const std::string& filename) 
+{
+    unsigned char prefix[12];
+    if (!file.readAt(prefix, 10, 0) || std::memcmp(prefix, kNumpyMagic, sizeof(kNumpyMagic)) != 0) 
+    {
+        throw std::runtime_error("Not a .npy file: " + filename);
+    }
+    
+    const unsigned major = prefix[6];
+    uint64_t length = 0;
+    uint64_t start = 0;
+    if (major == 1) 
+    {
+        length = prefix[8] | uint64_t(prefix[9]) << 8;
+        start = 10;
+    }
+    else if ((major == 2 || major == 3) && file.readAt(prefix + 10, 2, 10)) 
+    {
+        length = prefix[8] | uint64_t(prefix[9]) << 8 | uint64_t(prefix[10]) << 16 | uint64_t(prefix[11]) << 24;
+        start = 12;
+    }
+    else 
+    {
+        throw std::runtime_error("Unsupported .npy version: " + filename);
+    }
+    
+    if (start + length > file.size()) 
+    {
+        throw std::runtime_error("Truncated .npy file: " + filename);
+    }
+    std::string dict(length, '\0');
+    if (!file.readAt(dict.data(), length, start)) 
+    {
+        throw std::runtime_error("Truncated .npy file: " + filename);
+    }
+    
+    NumpyHeader header = parseNumpyHeader(dict);
+    header.dataOffset = start + length;
+    return header;
+}
+
+template <typename S, typename T>
+void convertNumpy(const char* data, size_t n, bool fortranOrder, Matrix<T>& matrix) 
+{
+    const S* source = reinterpret_cast<const S*>(data);
+    if (!fortranOrder) 
+    {
+        for (size_t i = 0; i < n; ++i) 
+        {
+            std::transform(source + i * n, source + i * n + n, &matrix(i, 0), [](S value) { return static_cast<T>(value); });
+        }
+        return;
+    }
+    
+    // Column-major source: transpose block by block so both sides stay in cache
+    constexpr size_t kBlock = 64;
+    for (size_t jb = 0; jb < n; jb += kBlock) 
+    {
+        for (size_t ib = 0; ib < n; ib += kBlock) 
+        {
+            for (size_t j = jb; j < std::min(n, jb + kBlock); ++j) 
+            {
+                for (size_t i = ib; i < std::min(n, ib + kBlock); ++i) 
+                {
+                    matrix(i, j) = static_cast<T>(source[j * n + i]);
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+bool holdsSmallIntegers(const Matrix<T>& matrix) 
+{
+    for (size_t i = 0; i < matrix.getSize(); ++i) 
+    {
+        for (size_t j = 0; j < matrix.getSize(); ++j) 
+        {
+            if (!isSmallInteger(static_cast<long double>(matrix(i, j)))) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool MatrixReader::isBinary(const std::string& filename) 
+{ 
+    return startsWith(filename, kMagic, sizeof(kMagic)); 
+}
+
+bool MatrixReader::isNumpy(const std::string& filename) 
+{ 
+    return startsWith(filename, kNumpyMagic, sizeof(kNumpyMagic)); 
+}
+
+template <typename T>
+Matrix<T> MatrixReader::readBinary(const std::string& filename, const AllocationPolicy& policy) 
+{
+    const OpenFile file(filename);
+    const uint64_t fileBytes = file.size();
+    
+    BinaryHeader header{};
+    if (!file.readAt(&header, sizeof(header), 0) || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) 
+    {
+        throw std::runtime_error("Not a binary matrix file: " + filename);
+    }
+    if (header.version != kVersion || header.layout != kRowMajor) 
+    {
+        throw std::runtime_error("Unsupported binary matrix version or layout: " + filename);
+    }
+    
+    // Every read below strides by elementBytes but converts by the tagged
+    // type, so the two have to agree before any offset is trusted
+    const size_t elementBytes = scalarBytes(header.scalar);
+    if (elementBytes == 0) 
+    {
+        throw std::runtime_error("Unknown scalar type in binary matrix file: " + filename);
+    }
+    if (header.elementBytes != elementBytes) 
+    {
+        throw std::runtime_error("Element size does not match the scalar type in binary matrix file: " + filename);
+    }
+    
+    const uint64_t available = (fileBytes - kHeaderBytes) / elementBytes;
+    if (header.stride < header.size || (header.size > 0 && header.stride > available / header.size)) 
+    {
+        throw std::runtime_error("Truncated binary matrix file: " + filename);
+    }
+    
+    Mapping mapping(file, static_cast<size_t>(fileBytes), filename);
+    const size_t n = static_cast<size_t>(header.size);
+    if (header.scalar == scalarTag<T>() && header.elementBytes == sizeof(T)) 
+    {
+        Matrix<T> matrix(mapping.adopt<T>(kHeaderBytes), n, static_cast<size_t>(header.stride), policy);
+        matrix.setIntegral(header.integral != 0);
+        return matrix;
+    }
+    
+    const char* data = mapping.at(kHeaderBytes);
+    Matrix<T> matrix(n, unfilled(policy));
+    switch (header.scalar) 
+    {
+        case scalarTag<float>():       convertRows<float>(data, header, matrix); break;
+        case scalarTag<double>():      convertRows<double>(data, header, matrix); break;
+        case scalarTag<long double>(): convertRows<long double>(data, header, matrix); break;
+#ifdef __SIZEOF_FLOAT128__
+        case scalarTag<__float128>():  convertRows<__float128>(data, header, matrix); break;
+#endif
+        default:
+            throw std::runtime_error("Unknown scalar type in binary matrix file: " + filename);
+    }
+    matrix.setIntegral(header.integral != 0);
+    return matrix;
+}
+
+template <typename T>
+Matrix<T> MatrixReader::readNumpy(const std::string& filename, const AllocationPolicy& policy) 
+{
+    const OpenFile file(filename);
+    const uint64_t fileBytes = file.size();
+    const NumpyHeader header = readNumpyHeader(file, filename);
+    
+    if (header.kind != 'f' || (header.elementBytes != sizeof(float) && header.elementBytes != sizeof(double))) 
+    {
+        throw std::runtime_error("Unsupported .npy element type (float32 and float64 only): " + filename);
+    }
+    if (header.byteOrder != '=' && header.byteOrder != kNativeOrder) 
+    {
+        throw std::runtime_error("Unsupported .npy byte order: " + filename);
+    }
+    if (header.shape.size() != 2 || header.shape[0] != header.shape[1]) 
+    {
+        throw std::runtime_error("Not a square matrix: " + filename);
+    }
+    
+    const uint64_t n = header.shape[0];
+    const uint64_t available = (fileBytes - header.dataOffset) / header.elementBytes;
+    if (n > 0 && n > available / n) 
+    {
+        throw std::runtime_error("Truncated .npy file: " + filename);
+    }
+    if (n == 0) 
+    {
+        return Matrix<T>(0, policy);
+    }
+    
+    Mapping mapping(file, static_cast<size_t>(fileBytes), filename);
+    
+    // NumPy pads the header so the data starts 64-byte aligned; older
+    // writers only went to 16, and those files are copied
+    const bool native = (std::is_same_v<T, float> && header.elementBytes == sizeof(float)) ||
+                        (std::is_same_v<T, double> && header.elementBytes == sizeof(double));
+    if (native && !header.fortranOrder && header.dataOffset % kCacheLineBytes == 0) 
+    {
+        Matrix<T> matrix(mapping.adopt<T>(static_cast<size_t>(header.dataOffset)), n, n, policy);
+        matrix.setIntegral(holdsSmallIntegers(matrix));
+        return matrix;
+    }
+    
+    const char* data = mapping.at(static_cast<size_t>(header.dataOffset));
+    Matrix<T> matrix(n, unfilled(policy));
+    if (header.elementBytes == sizeof(float)) 
+    {
+        convertNumpy<float>(data, n, header.fortranOrder, matrix);
+    }
+    else 
+    {
+        convertNumpy<double>(data, n, header.fortranOrder, matrix);
+    }
+    matrix.setIntegral(holdsSmallIntegers(matrix));
+    return matrix;
+}
+
+template <typename T>
+void MatrixWriter::writeBinary(const std::string& filename, const Matrix<T>& matrix) 
+{ 
+    writeBinary(filename, matrix.view(), matrix.isIntegral()); 
+}
+
+template <typename T>
+void MatrixWriter::writeBinary(const std::string& filename, MatrixView<const T> matrix, bool integral) 
+{
+    if (!matrix.isSquare()) 
+    {
+        throw std::invalid_argument("Binary matrix file of a non-square view");
+    }
+    
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) 
+    {
+        throw std::runtime_error("Cannot create file: " + filename);
+    }
+    
+    const size_t n = matrix.getSize();
+    const size_t stride = paddedStride<T>(n);
+    
+    BinaryHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.scalar = scalarTag<T>();
+    header.elementBytes = sizeof(T);
+    header.layout = kRowMajor;
+    header.size = n;
+    header.stride = stride;
+    header.integral = integral ? 1 : 0;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    
+    // Row padding is written as zeros, never as whatever the view's buffer holds
+    std::vector<T> row(stride, T(0));
+    for (size_t i = 0; i < n; ++i) 
+    {
+        std::copy(&matrix(i, 0), &matrix(i, 0) + n, row.begin());
+        file.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(stride * sizeof(T)));
+    }
+    
+    if (!file) 
+    {
+        throw std::runtime_error("Write failed: " + filename);
+    }
+}
+
+#define HWMX_INSTANTIATE(T) \
+    template Matrix<T> MatrixReader::readBinary<T>(const std::string&, const AllocationPolicy&); \
+    template Matrix<T> MatrixReader::readNumpy<T>(const std::string&, const AllocationPolicy&); \
+    template void MatrixWriter::writeBinary(const std::string&, const Matrix<T>&); \
+    template void MatrixWriter::writeBinary(const std::string&, MatrixView<const T>, bool);
+HWMX_FOR_EACH_SCALAR(HWMX_INSTANTIATE)
+#undef HWMX_INSTANTIATE
+
+} // namespace LinearAlgebra
@@ -0,0 +1,217 @@
+#include "determinant.h"
+#include "thread_pool.h"
+#include "lu_kernels.h"
+#include "engines.h"
+#include "scalar_traits.h"
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+
+namespace LinearAlgebra 
+{
+
+namespace 
+{
+
+// Factor the panel A[k0:n, k0:k0+kb] in place. Row swaps stay inside the
+// panel columns and are recorded in pivots[k0:k0+kb]; applySwaps brings the
+// other columns in line afterwards, one batch per panel as LAPACK's laswp.
+// Returns false when a pivot falls below the singularity threshold.
+template <typename T>
+bool factorPanel(MatrixView<T> matrix, size_t k0, size_t kb, size_t* pivots, PivotProduct<T>& product) 
+{
+    const size_t n = matrix.getSize();
+    T* a = matrix.getData();
+    const size_t lda = matrix.getStride();
+    const size_t panel_end = k0 + kb;
+    
+    for (size_t k = k0; k < panel_end; ++k) 
+    {
+        // Find pivot row
+        size_t pivot_row = k;
+        T max_val = ScalarTraits<T>::abs(a[k * lda + k]);
+        
+        for (size_t i = k + 1; i < n; ++i) 
+        {
+            T val = ScalarTraits<T>::abs(a[i * lda + k]);
+            if (val > max_val) 
+            {
+                max_val = val;
+                pivot_row = i;
+            }
+        }
+        
+        pivots[k] = pivot_row;
+        if (pivot_row != k) 
+        {
+            std::swap_ranges(a + k * lda + k0, a + k * lda + panel_end, a + pivot_row * lda + k0);
+            product.negate();
+        }
+        
+        const T* row_k = a + k * lda;
+        T pivot_val = row_k[k];
+        
+        if (ScalarTraits<T>::abs(pivot_val) < T(1e-15L)) 
+        {
+            return false;
+        }
+        
+        product.multiply(pivot_val);
+        
+        // Eliminate below diagonal, restricted to the panel columns
+        for (size_t i = k + 1; i < n; ++i) 
+        {
+            T* row_i = a + i * lda;
+            T factor = row_i[k] / pivot_val;
+            row_i[k] = factor;
+            
+            for (size_t j = k + 1; j < panel_end; ++j) 
+            {
+                row_i[j] -= factor * row_k[j];
+            }
+        }
+    }
+    
+    return true;
+}
+
+// Replay the row swaps of panel [k0, k0 + kb) on columns [first, last)
+template <typename T>
+void applySwaps(MatrixView<T> matrix, size_t k0, size_t kb, const size_t* pivots, size_t first, size_t last) 
+{
+    T* a = matrix.getData();
+    const size_t lda = matrix.getStride();
+    
+    for (size_t r = k0; r < k0 + kb; ++r) 
+    {
+        if (pivots[r] != r) 
+        {
+            std::swap_ranges(a + r * lda + first, a + r * lda + last, a + pivots[r] * lda + first);
+        }
+    }
+}
+
+// Solve for U12 and apply A22 -= L21 * U12. Column tiles of U12 take the
+// panel's row swaps and are solved and packed independently, then every
+// (row tile, column tile) pair of A22 is an independent task. Serially the
+// loop runs column tile by column tile so the packed kb x tileSize slab
+// stays cache resident.
+template <typename T>
+void updateTrailing(MatrixView<T> matrix, size_t k0, size_t kb, size_t tileSize, const size_t* pivots, T* packed, ThreadPool* pool) 
+{
+    const size_t n = matrix.getSize();
+    const size_t start = k0 + kb;
+    const size_t tiles = (n - start + tileSize - 1) / tileSize;
+    
+    T* a = matrix.getData();
+    const size_t lda = matrix.getStride();
+    
+    auto prepareColumns = [&](size_t tj, size_t) 
+    {
+        const size_t jj = start + tj * tileSize;
+        const size_t cols = std::min(tileSize, n - jj);
+        T* u = a + k0 * lda + jj;
+        applySwaps(matrix, k0, kb, pivots, jj, jj + cols);
+        LuKernels::solveUnitLower(a + k0 * lda + k0, lda, u, lda, kb, cols);
+        LuKernels::packTransposed(u, lda, kb, cols, packed + (jj - start) * kb);
+    };
+    auto updatePair = [&](size_t pair, size_t) 
+    {
+        const size_t tj = pair / tiles;
+        const size_t ti = pair % tiles;
+        const size_t jj = start + tj * tileSize;
+        const size_t ii = start + ti * tileSize;
+        LuKernels::multiplySubtract(a + ii * lda + jj, lda, a + ii * lda + k0, lda, packed + (jj - start) * kb,
+                                    std::min(tileSize, n - ii), std::min(tileSize, n - jj), kb);
+    };
+    
+    if (pool) 
+    {
+        // By reference: a copied closure this size would be heap-allocated
+        // by std::function on every panel
+        pool->parallelFor(tiles, std::ref(prepareColumns));
+        pool->parallelFor(tiles * tiles, std::ref(updatePair));
+        return;
+    }
+    
+    for (size_t tj = 0; tj < tiles; ++tj) 
+    {
+        prepareColumns(tj, 0);
+        for (size_t ti = 0; ti < tiles; ++ti) 
+        {
+            updatePair(tj * tiles + ti, 0);
+        }
+    }
+}
+
+} // namespace
+
+template <typename T>
+PivotProduct<T> Engines::blocked(MatrixView<T> matrix, size_t panelWidth, size_t tileSize, ThreadPool* pool, 
+                                 bool logicalPivoting, size_t* permutation) 
+{
+    const size_t n = matrix.getSize();
+    
+    if (panelWidth == 0 || tileSize == 0) 
+    {
+        throw std::invalid_argument("Block sizes must be positive");
+    }
+    
+    PivotProduct<T> product;
+    
+    if (n == 0) return product;
+    if (n == 1) 
+    {
+        product.multiply(matrix(0, 0));
+        return product;
+    }
+    
+    const AllocationPolicy scratch{ false, &BufferPool::shared() };
+    AlignedArray<T> packed = allocateAligned<T>(panelWidth * n, scratch);
+    AlignedArray<size_t> pivots = allocateAligned<size_t>(n, scratch);
+    std::iota(pivots.get(), pivots.get() + n, size_t(0));
+    
+    // Right-looking blocked LU with partial pivoting
+    for (size_t k0 = 0; k0 < n; k0 += panelWidth) 
+    {
+        const size_t kb = std::min(panelWidth, n - k0);
+        
+        if (!factorPanel(matrix, k0, kb, pivots.get(), product)) 
+        {
+            product.markSingular();
+            break;
+        }
+        
+        // The determinant never reads L, so logical pivoting leaves the
+        // finished panels in the row order they were factored in
+        if (!logicalPivoting) 
+        {
+            applySwaps(matrix, k0, kb, pivots.get(), 0, k0);
+        }
+        
+        if (k0 + kb < n) 
+        {
+            updateTrailing(matrix, k0, kb, tileSize, pivots.get(), packed.get(), pool);
+        }
+    }
+    
+    if (permutation) 
+    {
+        std::iota(permutation, permutation + n, size_t(0));
+        for (size_t k = 0; k < n; ++k) 
+        {
+            std::swap(permutation[k], permutation[pivots[k]]);
+        }
+    }
+    
+    return product;
+}
+
+#define HWMX_INSTANTIATE(T) \
+    template PivotProduct<T> Engines::blocked(MatrixView<T>, size_t, size_t, ThreadPool*, bool, size_t*);
+HWMX_FOR_EACH_SCALAR(HWMX_INSTANTIATE)
+#undef HWMX_INSTANTIATE
+
+} // namespace LinearAlgebra
@@ -1,72 +1,199 @@
 #include "determinant.h"
+#include "thread_pool.h"
+#include "engines.h"
+#include "big_integer.h"
+#include "scalar_traits.h"
+#include "text_parser.h"
+#include "simd_kernels.h"
 #include <iostream>
-#include <fstream>
 #include <sstream>
 #include <cmath>
 #include <chrono>
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <iomanip>
+#include <numeric>
+#include <stdexcept>
 
 namespace LinearAlgebra 
 {
 
-size_t Matrix::index(size_t i, size_t j) const 
+namespace 
+{
+
+// Base page size: one write anywhere in a page faults all of it in
+constexpr size_t kPageBytes = 4096;
+
+AllocationPolicy unfilled(AllocationPolicy policy) 
+{
+    policy.zeroFill = false;
+    return policy;
+}
+
+} // namespace
+
+template <typename T>
+size_t Matrix<T>::index(size_t i, size_t j) const 
 { 
-    return i * size + j; 
+    return i * stride + j; 
 }
 
-Matrix::Matrix(size_t n) : size(n), data(std::make_unique<long double[]>(n * n)) 
+template <typename T>
+Matrix<T>::Matrix(size_t n) : Matrix(n, paddedStride<T>(n)) 
 {
 }
 
-Matrix::Matrix(const Matrix& other) : size(other.size), data(std::make_unique<long double[]>(other.size * other.size)) 
+template <typename T>
+Matrix<T>::Matrix(size_t n, const AllocationPolicy& policy) : Matrix(n, paddedStride<T>(n), policy) 
 {
-    std::copy(other.data.get(), other.data.get() + size * size, data.get());
 }
 
-Matrix::Matrix(Matrix&& other) noexcept : size(other.size), data(std::move(other.data)) 
+template <typename T>
+Matrix<T>::Matrix(size_t n, size_t leadingDimension, const AllocationPolicy& policy) : size(n), stride(leadingDimension), policy(policy) 
+{
+    if (stride < size) 
+    {
+        throw std::invalid_argument("Leading dimension is smaller than the matrix size");
+    }
+    
+    if (policy.firstTouchThreads <= 1 || size == 0) 
+    {
+        data = allocateAligned<T>(size * stride, policy);
+        return;
+    }
+    
+    // Fault the rows in tile by tile from a pool, so the pages of each row
+    // tile come from one of the threads rather than all from this one. A
+    // buffer the caller overwrites anyway gets one write per page, not a fill.
+    AllocationPolicy untouched = policy;
+    untouched.zeroFill = false;
+    data = allocateAligned<T>(size * stride, untouched);
+    
+    const size_t tileRows = std::max<size_t>(policy.firstTouchRows, 1);
+    const size_t tiles = (size + tileRows - 1) / tileRows;
+    const size_t pageElements = std::max<size_t>(kPageBytes / sizeof(T), 1);
+    ThreadPool pool(std::min(policy.firstTouchThreads, tiles));
+    pool.parallelFor(tiles, [&](size_t tile, size_t) 
+    {
+        T* begin = data.get() + tile * tileRows * stride;
+        const size_t count = std::min(tileRows, size - tile * tileRows) * stride;
+        if (policy.zeroFill) 
+        {
+            std::fill_n(begin, count, T(0));
+            return;
+        }
+        for (size_t k = 0; k < count; k += pageElements) 
+        {
+            begin[k] = T(0);
+        }
+        begin[count - 1] = T(0);
+    });
+}
+
+template <typename T>
+Matrix<T>::Matrix(AlignedArray<T> buffer, size_t n, size_t leadingDimension, const AllocationPolicy& policy) 
+    : data(std::move(buffer)), size(n), stride(leadingDimension), policy(policy) 
+{
+    if (stride < size) 
+    {
+        throw std::invalid_argument("Leading dimension is smaller than the matrix size");
+    }
+}
+
+// Copies are allocated and placed like the source but skip the fill they
+// would overwrite
+template <typename T>
+Matrix<T>::Matrix(const Matrix& other) : Matrix(other.size, other.stride, unfilled(other.policy)) 
+{
+    policy = other.policy;
+    integral = other.integral;
+    std::copy(other.data.get(), other.data.get() + size * stride, data.get());
+}
+
+template <typename T>
+Matrix<T>::Matrix(Matrix&& other) noexcept : data(std::move(other.data)), size(other.size), stride(other.stride), policy(other.policy), integral(other.integral) 
 {
     other.size = 0;
+    other.stride = 0;
 }
 
-Matrix& Matrix::operator=(const Matrix& other) 
+template <typename T>
+Matrix<T>& Matrix<T>::operator=(const Matrix& other) 
 {
     if (this != &other) 
     {
-        size = other.size;
-        data = std::make_unique<long double[]>(size * size);
-        std::copy(other.data.get(), other.data.get() + size * size, data.get());
+        *this = Matrix(other);
     }
     return *this;
 }
 
-Matrix& Matrix::operator=(Matrix&& other) noexcept 
+template <typename T>
+Matrix<T>& Matrix<T>::operator=(Matrix&& other) noexcept 
 {
     if (this != &other) 
     {
         size = other.size;
+        stride = other.stride;
+        policy = other.policy;
         data = std::move(other.data);
+        integral = other.integral;
         other.size = 0;
+        other.stride = 0;
     }
     return *this;
 }
 
-long double& Matrix::operator()(size_t i, size_t j) 
+template <typename T>
+T& Matrix<T>::operator()(size_t i, size_t j) 
 { 
     return data[index(i, j)]; 
 }
 
-const long double& Matrix::operator()(size_t i, size_t j) const 
+template <typename T>
+const T& Matrix<T>::operator()(size_t i, size_t j) const 
 { 
     return data[index(i, j)]; 
 }
 
-size_t Matrix::getSize() const 
+template <typename T>
+T* Matrix<T>::getData() 
+{ 
+    return data.get(); 
+}
+
+template <typename T>
+const T* Matrix<T>::getData() const 
+{ 
+    return data.get(); 
+}
+
+template <typename T>
+size_t Matrix<T>::getSize() const 
 { 
     return size; 
 }
 
-void Matrix::swapRows(size_t i, size_t j) 
+template <typename T>
+size_t Matrix<T>::getStride() const 
+{ 
+    return stride; 
+}
+
+template <typename T>
+bool Matrix<T>::isIntegral() const 
+{ 
+    return integral; 
+}
+
+template <typename T>
+void Matrix<T>::setIntegral(bool value) 
+{ 
+    integral = value; 
+}
+
+template <typename T>
+void Matrix<T>::swapRows(size_t i, size_t j) 
 {
     if (i == j) return;
     for (size_t k = 0; k < size; ++k) 
@@ -75,37 +202,124 @@ void Matrix::swapRows(size_t i, size_t j)
     }
 }
 
-Matrix Matrix::copy() const 
+template <typename T>
+Matrix<T> Matrix<T>::copy() const 
 {
     return Matrix(*this);
 }
 
-long double DeterminantCalculator::calculateDeterminant(Matrix& matrix) 
+template <typename T>
+MatrixView<T> Matrix<T>::view() 
+{
+    return MatrixView<T>(data.get(), size, size, stride);
+}
+
+template <typename T>
+MatrixView<const T> Matrix<T>::view() const 
+{
+    return MatrixView<const T>(data.get(), size, size, stride);
+}
+
+// Every element a view of the buffer exposes is copied in before it is read
+template <typename T>
+Workspace<T>::Workspace(const AllocationPolicy& policy) : policy(unfilled(policy)) 
+{
+}
+
+template <typename T>
+Workspace<T>::Workspace(size_t n, const AllocationPolicy& policy) : Workspace(policy) 
+{
+    reserve(n);
+}
+
+template <typename T>
+Workspace<T>::Workspace(Workspace&& other) noexcept = default;
+
+template <typename T>
+Workspace<T>& Workspace<T>::operator=(Workspace&& other) noexcept = default;
+
+template <typename T>
+Workspace<T>::~Workspace() = default;
+
+template <typename T>
+MatrixView<T> Workspace<T>::reserve(size_t n) 
+{
+    const size_t stride = paddedStride<T>(n);
+    if (n * stride > capacity) 
+    {
+        data = allocateAligned<T>(n * stride, policy);
+        capacity = n * stride;
+    }
+    return MatrixView<T>(data.get(), n, n, stride);
+}
+
+template <typename T>
+ThreadPool* Workspace<T>::getPool(size_t threads) 
+{
+    if (threads <= 1) return nullptr;
+    if (!pool || pool->getThreadCount() != threads) 
+    {
+        pool = std::make_unique<ThreadPool>(threads);
+    }
+    return pool.get();
+}
+
+template <typename T>
+size_t Workspace<T>::getCapacity() const 
+{
+    return capacity;
+}
+
+namespace 
+{
+
+// Below this many trailing elements a step is cheaper than a fork-join
+constexpr size_t kParallelStepWork = 64 * 1024;
+
+} // namespace
+
+template <typename T>
+PivotProduct<T> Engines::unblocked(MatrixView<T> matrix, ThreadPool* pool, bool logicalPivoting, size_t* permutation) 
 {
     const size_t n = matrix.getSize();
+    PivotProduct<T> product;
     
-    if (n == 0) return 1.0L;
-    if (n == 1) return matrix(0, 0);
+    if (n == 0) return product;
+    if (n == 1) 
+    {
+        product.multiply(matrix(0, 0));
+        return product;
+    }
     
-    std::unique_ptr<size_t[]> pivot = std::make_unique<size_t[]>(n);
+    // order[i] is the input row that becomes row i of the factors. With
+    // logical pivoting no row is ever moved: row i is reached through
+    // order[i], and a pivot swap exchanges two indices instead of two rows.
+    AlignedArray<size_t> local;
+    size_t* order = permutation;
+    if (!order) 
+    {
+        local = allocateAligned<size_t>(n, AllocationPolicy{ false, &BufferPool::shared() });
+        order = local.get();
+    }
     for (size_t i = 0; i < n; ++i) 
     {
-        pivot[i] = i;
+        order[i] = i;
     }
     
-    long double det = 1.0L;
-    int sign = 1;
+    T* a = matrix.getData();
+    const size_t lda = matrix.getStride();
+    auto row = [&](size_t i) { return a + (logicalPivoting ? order[i] : i) * lda; };
     
     // LU decomposition with partial pivoting
     for (size_t k = 0; k < n; ++k) 
     {
         // Find pivot row
         size_t pivot_row = k;
-        long double max_val = std::fabsl(matrix(k, k));
+        T max_val = ScalarTraits<T>::abs(row(k)[k]);
         
         for (size_t i = k + 1; i < n; ++i) 
         {
-            long double val = std::fabsl(matrix(i, k));
+            T val = ScalarTraits<T>::abs(row(i)[k]);
             if (val > max_val) 
             {
                 max_val = val;
@@ -116,82 +330,432 @@ long double DeterminantCalculator::calculateDeterminant(Matrix& matrix)
         // Swap rows if necessary
         if (pivot_row != k) 
         {
-            matrix.swapRows(k, pivot_row);
-            std::swap(pivot[k], pivot[pivot_row]);
-            sign = -sign;
+            if (!logicalPivoting) 
+            {
+                matrix.swapRows(k, pivot_row);
+            }
+            std::swap(order[k], order[pivot_row]);
+            product.negate();
         }
         
-        long double pivot_val = matrix(k, k);
+        const T* row_k = row(k);
+        T pivot_val = row_k[k];
         
         // Check for singular matrix
-        if (std::fabsl(pivot_val) < 1e-15L) 
+        if (ScalarTraits<T>::abs(pivot_val) < T(1e-15L)) 
         {
-            return 0.0L;
+            product.markSingular();
+            return product;
         }
         
-        det *= pivot_val;
+        product.multiply(pivot_val);
         
-        // Eliminate below diagonal
-        for (size_t i = k + 1; i < n; ++i) 
+        // Eliminate below diagonal; rows are independent of each other
+        auto eliminateRows = [&](size_t first, size_t last) 
+        {
+            for (size_t i = first; i < last; ++i) 
+            {
+                T* row_i = row(i);
+                T factor = row_i[k] / pivot_val;
+                row_i[k] = factor;
+                
+                for (size_t j = k + 1; j < n; ++j) 
+                {
+                    row_i[j] -= factor * row_k[j];
+                }
+            }
+        };
+        
+        const size_t rows = n - k - 1;
+        if (pool && rows * rows >= kParallelStepWork) 
+        {
+            const size_t chunks = std::min(rows, pool->getThreadCount() * 4);
+            pool->parallelFor(chunks, [&](size_t chunk, size_t) 
+            {
+                eliminateRows(k + 1 + rows * chunk / chunks, k + 1 + rows * (chunk + 1) / chunks);
+            });
+        }
+        else 
+        {
+            eliminateRows(k + 1, n);
+        }
+    }
+    
+    return product;
+}
+
+namespace 
+{
+
+// Rows first..size-1 of a text matrix from the mapped bytes [begin, end),
+// which start at row `first`. The bytes are cut into newline-aligned chunks;
+// a SIMD count of the '\n' in each gives the row its first line lands in,
+// and every chunk is then parsed straight into those rows, all of them at
+// once. Lines past the last row are ignored, as the sequential reader does.
+template <typename T>
+bool parseRowsInParallel(const char* begin, const char* end, size_t first, Matrix<T>& matrix, ThreadPool& pool) 
+{
+    using Parsed = typename ScalarTraits<T>::Parsed;
+    constexpr size_t kMinChunkBytes = size_t(1) << 16;
+    
+    const size_t size = matrix.getSize();
+    const size_t bytes = static_cast<size_t>(end - begin);
+    const size_t chunks = std::max<size_t>(1, std::min(pool.getThreadCount() * 4, bytes / kMinChunkBytes));
+    
+    // Chunk c starts at the first line that begins at or after its share
+    std::vector<const char*> bounds(chunks + 1, end);
+    bounds[0] = begin;
+    for (size_t c = 1; c < chunks; ++c) 
+    {
+        const char* nominal = std::max(begin + bytes * c / chunks - 1, bounds[c - 1]);
+        const void* newline = std::memchr(nominal, '\n', static_cast<size_t>(end - nominal));
+        bounds[c] = newline ? static_cast<const char*>(newline) + 1 : end;
+    }
+    
+    // A last line without its '\n' still counts
+    std::vector<size_t> rows(chunks + 1, 0);
+    pool.parallelFor(chunks, [&](size_t c, size_t) 
+    {
+        const size_t length = static_cast<size_t>(bounds[c + 1] - bounds[c]);
+        rows[c + 1] = Simd::kernels().countByte(bounds[c], length, '\n');
+        if (bounds[c + 1] == end && length > 0 && *(end - 1) != '\n') ++rows[c + 1];
+    });
+    rows[0] = first;
+    for (size_t c = 0; c < chunks; ++c) 
+    {
+        rows[c + 1] += rows[c];
+    }
+    
+    std::atomic<bool> integral{ true };
+    pool.parallelFor(chunks, [&](size_t c, size_t) 
+    {
+        const char* cursor = bounds[c];
+        bool chunkIntegral = true;
+        for (size_t i = rows[c]; i < std::min(rows[c + 1], size); ++i) 
         {
-            long double factor = matrix(i, k) / pivot_val;
-            matrix(i, k) = factor;
-            
-            for (size_t j = k + 1; j < n; ++j) 
+            const char* lineEnd = std::find(cursor, bounds[c + 1], '\n');
+            T* row = &matrix(i, 0);
+            for (size_t j = 0; j < size; ++j) 
             {
-                matrix(i, j) -= factor * matrix(k, j);
+                Parsed entry;
+                if (!TextParser::parseValue(cursor, lineEnd, entry)) 
+                {
+                    throw std::runtime_error("Invalid matrix format: not enough columns");
+                }
+                row[j] = static_cast<T>(entry);
+                chunkIntegral = chunkIntegral && isSmallInteger(entry);
             }
+            cursor = lineEnd == bounds[c + 1] ? lineEnd : lineEnd + 1;
         }
+        if (!chunkIntegral) integral.store(false, std::memory_order_relaxed);
+    });
+    
+    if (rows[chunks] < size) 
+    {
+        throw std::runtime_error("Invalid matrix format: not enough rows");
     }
+    return integral.load();
+}
+
+// permutation, when given, has room for n entries and receives the row
+// order of the factorization; only the unblocked and blocked engines keep one.
+// pool, when given, replaces the one the unblocked, blocked and simd engines
+// would otherwise start for options.threads
+template <typename T>
+PivotProduct<T> runEngine(MatrixView<T> matrix, const DeterminantCalculator::Options& options, size_t* permutation = nullptr, 
+                          ThreadPool* pool = nullptr) 
+{
+    using DeterminantCalculator::Engine;
     
-    return det * static_cast<long double>(sign);
+    if (!matrix.isSquare()) 
+    {
+        throw std::invalid_argument("Determinant of a non-square view");
+    }
+    if (permutation && options.engine != Engine::Unblocked && options.engine != Engine::Blocked) 
+    {
+        throw std::invalid_argument(std::string("Row permutation is not reported by the ") + 
+                                    DeterminantCalculator::engineName(options.engine) + " engine");
+    }
+    
+    std::unique_ptr<ThreadPool> local;
+    const bool pooled = options.engine == Engine::Unblocked || options.engine == Engine::Blocked || options.engine == Engine::Simd || 
+                        options.engine == Engine::Adaptive;
+    if (!pool && pooled && options.threads > 1) 
+    {
+        local = std::make_unique<ThreadPool>(options.threads);
+        pool = local.get();
+    }
+    
+    switch (options.engine) 
+    {
+        case Engine::Unblocked:
+            return Engines::unblocked(matrix, pool, options.logicalPivoting, permutation);
+        case Engine::Blocked:
+            return Engines::blocked(matrix, options.panelWidth, options.tileSize, pool, 
+                                    options.logicalPivoting, permutation);
+        case Engine::Simd:
+            return Engines::simd<T>(matrix, pool, nullptr);
+        case Engine::Adaptive:
+            return Engines::adaptive(matrix, options, pool);
+        case Engine::Tiled:
+            return Engines::tiled(matrix, options.tileSize, options.threads);
+        case Engine::TileMajor:
+            return Engines::tileMajor<T>(matrix, options.tileSize, options.threads);
+        case Engine::Recursive:
+            return Engines::recursive(matrix);
+        case Engine::Bareiss:
+        case Engine::Modular:
+        {
+            PivotProduct<T> product;
+            const BigInteger det = DeterminantCalculator::calculateExactDeterminant<T>(matrix, options);
+            if (det.isZero()) 
+            {
+                product.markSingular();
+                return product;
+            }
+            long exponent = 0;
+            product.multiply(static_cast<T>(det.toMantissa(exponent)));
+            product.multiplyByPowerOfTwo(exponent);
+            return product;
+        }
+    }
+    throw std::invalid_argument("Unknown determinant engine");
+}
+
+template <typename T>
+PivotProduct<T> runInWorkspace(MatrixView<const T> matrix, const DeterminantCalculator::Options& options, Workspace<T>& workspace) 
+{
+    if (!matrix.isSquare()) 
+    {
+        throw std::invalid_argument("Determinant of a non-square view");
+    }
+    
+    const size_t n = matrix.getSize();
+    MatrixView<T> copy = workspace.reserve(n);
+    for (size_t i = 0; i < n; ++i) 
+    {
+        std::copy(&matrix(i, 0), &matrix(i, 0) + n, &copy(i, 0));
+    }
+    return runEngine(copy, options, nullptr, workspace.getPool(options.threads));
+}
+
+} // namespace
+
+template <typename T>
+T DeterminantCalculator::calculateDeterminant(Matrix<T>& matrix) 
+{
+    return Engines::unblocked(matrix.view(), nullptr, false, nullptr).value();
+}
+
+template <typename T>
+T DeterminantCalculator::calculateDeterminant(Matrix<T>& matrix, const Options& options) 
+{
+    return runEngine(matrix.view(), options).value();
+}
+
+template <typename T>
+T DeterminantCalculator::calculateDeterminant(Matrix<T>& matrix, const Options& options, std::vector<size_t>& permutation) 
+{
+    permutation.resize(matrix.getSize());
+    std::iota(permutation.begin(), permutation.end(), size_t(0));
+    return runEngine(matrix.view(), options, permutation.data()).value();
+}
+
+template <typename T>
+DeterminantCalculator::LogDeterminant DeterminantCalculator::logDeterminant(Matrix<T>& matrix, const Options& options) 
+{
+    return runEngine(matrix.view(), options).logValue();
+}
+
+template <typename T>
+T DeterminantCalculator::calculateDeterminant(MatrixView<T> matrix, const Options& options) 
+{
+    return runEngine(matrix, options).value();
+}
+
+template <typename T>
+DeterminantCalculator::LogDeterminant DeterminantCalculator::logDeterminant(MatrixView<T> matrix, const Options& options) 
+{
+    return runEngine(matrix, options).logValue();
 }
 
-Matrix MatrixReader::readFromFile(const std::string& filename) 
+template <typename T>
+T DeterminantCalculator::calculateDeterminant(const Matrix<T>& matrix, const Options& options, Workspace<T>& workspace) 
 {
-    std::ifstream file(filename);
-    if (!file.is_open()) 
+    return calculateDeterminant(matrix.view(), options, workspace);
+}
+
+template <typename T>
+T DeterminantCalculator::calculateDeterminant(MatrixView<const T> matrix, const Options& options, Workspace<T>& workspace) 
+{
+    return runInWorkspace(matrix, options, workspace).value();
+}
+
+template <typename T>
+DeterminantCalculator::LogDeterminant DeterminantCalculator::logDeterminant(const Matrix<T>& matrix, const Options& options, Workspace<T>& workspace) 
+{
+    return logDeterminant(matrix.view(), options, workspace);
+}
+
+template <typename T>
+DeterminantCalculator::LogDeterminant DeterminantCalculator::logDeterminant(MatrixView<const T> matrix, const Options& options, Workspace<T>& workspace) 
+{
+    return runInWorkspace(matrix, options, workspace).logValue();
+}
+
+template <typename T>
+BigInteger DeterminantCalculator::calculateExactDeterminant(const Matrix<T>& matrix, const Options& options) 
+{
+    return calculateExactDeterminant(matrix.view(), options);
+}
+
+template <typename T>
+BigInteger DeterminantCalculator::calculateExactDeterminant(MatrixView<const T> matrix, const Options& options) 
+{
+    if (options.engine == Engine::Modular) 
     {
-        throw std::runtime_error("Cannot open file: " + filename);
+        return calculateModularDeterminant(matrix, options.threads, options.earlyTermination);
+    }
+    return calculateBareissDeterminant(matrix);
+}
+
+template <typename T>
+T DeterminantCalculator::calculateBlockedDeterminant(Matrix<T>& matrix, size_t panelWidth, size_t tileSize, size_t threads) 
+{
+    std::unique_ptr<ThreadPool> pool = threads > 1 ? std::make_unique<ThreadPool>(threads) : nullptr;
+    return Engines::blocked(matrix.view(), panelWidth, tileSize, pool.get(), false, nullptr).value();
+}
+
+template <typename T>
+double DeterminantCalculator::calculateSimdDeterminant(const Matrix<T>& matrix, size_t threads) 
+{
+    std::unique_ptr<ThreadPool> pool = threads > 1 ? std::make_unique<ThreadPool>(threads) : nullptr;
+    // Widened before value(): the product of a float matrix's pivots leaves
+    // float's range long before double's
+    return Engines::simd(matrix.view(), pool.get(), nullptr).template as<double>().value();
+}
+
+template <typename T>
+T DeterminantCalculator::calculateTiledDeterminant(Matrix<T>& matrix, size_t tileSize, size_t threads) 
+{
+    return Engines::tiled(matrix.view(), tileSize, threads).value();
+}
+
+template <typename T>
+T DeterminantCalculator::calculateRecursiveDeterminant(Matrix<T>& matrix) 
+{
+    return Engines::recursive(matrix.view()).value();
+}
+
+const char* DeterminantCalculator::engineName(Engine engine) 
+{
+    switch (engine) 
+    {
+        case Engine::Unblocked: return "unblocked";
+        case Engine::Blocked:   return "blocked";
+        case Engine::Simd:      return "simd";
+        case Engine::Tiled:     return "tiled";
+        case Engine::TileMajor: return "tile-major";
+        case Engine::Adaptive:  return "adaptive";
+        case Engine::Recursive: return "recursive";
+        case Engine::Bareiss:   return "bareiss";
+        case Engine::Modular:   return "modular";
+    }
+    return "unknown";
+}
+
+DeterminantCalculator::Engine DeterminantCalculator::parseEngine(const std::string& name) 
+{
+    if (name == "unblocked") return Engine::Unblocked;
+    if (name == "blocked")   return Engine::Blocked;
+    if (name == "simd")      return Engine::Simd;
+    if (name == "tiled")     return Engine::Tiled;
+    if (name == "tile-major") return Engine::TileMajor;
+    if (name == "adaptive")  return Engine::Adaptive;
+    if (name == "recursive") return Engine::Recursive;
+    if (name == "bareiss")   return Engine::Bareiss;
+    if (name == "modular")   return Engine::Modular;
+    throw std::invalid_argument("Unknown engine: " + name);
+}
+
+template <typename T>
+Matrix<T> MatrixReader::readFromFile(const std::string& filename, const AllocationPolicy& policy, size_t threads) 
+{
+    using Parsed = typename ScalarTraits<T>::Parsed;
+    
+    if (isBinary(filename)) 
+    {
+        return readBinary<T>(filename, policy);
+    }
+    if (isNumpy(filename)) 
+    {
+        return readNumpy<T>(filename, policy);
     }
     
-    size_t size = 0;
-    std::string line;
-    std::getline(file, line);
+    TextParser::LineSource source(filename);
+    const char* line = nullptr;
+    const char* end = nullptr;
     
-    std::istringstream first_line(line);
-    long double value;
-    while (first_line >> value) 
+    // The first row is parsed once, into a side buffer, and gives the order;
+    // nothing is ever read twice, so the source may be a pipe
+    std::vector<Parsed> first;
+    if (source.nextLine(line, end)) 
     {
-        ++size;
+        Parsed entry;
+        while (TextParser::parseValue(line, end, entry)) 
+        {
+            first.push_back(entry);
+        }
     }
+    const size_t size = first.size();
     
-    file.clear();
-    file.seekg(0);
+    Matrix<T> matrix(size, unfilled(policy));
+    bool integral = true;
     
-    Matrix matrix(size);
+    for (size_t j = 0; j < size; ++j) 
+    {
+        matrix(0, j) = static_cast<T>(first[j]);
+        integral = integral && isSmallInteger(first[j]);
+    }
     
-    for (size_t i = 0; i < size; ++i) 
+    const char* rest = nullptr;
+    const char* restEnd = nullptr;
+    if (threads > 1 && size > 1 && source.unread(rest, restEnd)) 
+    {
+        ThreadPool pool(threads);
+        const bool rowsIntegral = parseRowsInParallel(rest, restEnd, 1, matrix, pool);
+        matrix.setIntegral(integral && rowsIntegral);
+        return matrix;
+    }
+    
+    // The remaining values go from the source straight into the rows;
+    // whatever follows the first `size` values of a line is ignored
+    for (size_t i = 1; i < size; ++i) 
     {
-        if (!std::getline(file, line)) 
+        if (!source.nextLine(line, end)) 
         {
             throw std::runtime_error("Invalid matrix format: not enough rows");
         }
         
-        std::istringstream iss(line);
+        T* row = &matrix(i, 0);
         for (size_t j = 0; j < size; ++j) 
         {
-            if (!(iss >> matrix(i, j))) 
+            Parsed entry;
+            if (!TextParser::parseValue(line, end, entry)) 
             {
                 throw std::runtime_error("Invalid matrix format: not enough columns");
             }
+            row[j] = static_cast<T>(entry);
+            integral = integral && isSmallInteger(entry);
         }
     }
     
+    matrix.setIntegral(integral);
     return matrix;
 }
 
-Matrix MatrixReader::readFromUserInput() 
+template <typename T>
+Matrix<T> MatrixReader::readFromUserInput(const AllocationPolicy& policy) 
 {
     std::cout << "Enter matrix size N: ";
     size_t size;
@@ -199,10 +763,11 @@ Matrix MatrixReader::readFromUserInput()
     
     if (size == 0) 
     {
-        return Matrix(0);
+        return Matrix<T>(0, policy);
     }
     
-    Matrix matrix(size);
+    Matrix<T> matrix(size, unfilled(policy));
+    bool integral = true;
     
     std::cout << "Enter " << size << "x" << size << " matrix elements row by row:" << std::endl;
     std::cin.ignore();
@@ -216,28 +781,81 @@ Matrix MatrixReader::readFromUserInput()
         std::istringstream iss(line);
         for (size_t j = 0; j < size; ++j) 
         {
-            if (!(iss >> matrix(i, j))) 
+            typename ScalarTraits<T>::Parsed value;
+            if (!(iss >> value)) 
             {
                 throw std::runtime_error("Invalid input: not enough numbers in row " + std::to_string(i + 1));
             }
+            matrix(i, j) = static_cast<T>(value);
+            integral = integral && isSmallInteger(value);
         }
         
-        long double extra;
+        typename ScalarTraits<T>::Parsed extra;
         if (iss >> extra) 
         {
             throw std::runtime_error("Invalid input: too many numbers in row " + std::to_string(i + 1));
         }
     }
     
+    matrix.setIntegral(integral);
     return matrix;
 }
 
 void printUsage(const std::string& programName) 
 {
     std::cout << "Usage:" << std::endl;
-    std::cout << "  " << programName << " <matrix_file.txt>  - Calculate determinant from file" << std::endl;
-    std::cout << "  " << programName << "                   - Enter matrix manually" << std::endl;
-    std::cout << "Using long double precision with partial pivoting LU decomposition" << std::endl;
+    std::cout << "  " << programName << " [options] <matrix_file.txt>  - Calculate determinant from file" << std::endl;
+    std::cout << "  " << programName << " [options] -                  - Read the matrix from standard input" << std::endl;
+    std::cout << "  " << programName << " [options]                    - Enter matrix manually" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --engine=NAME   Engine: unblocked, blocked, simd, tiled, tile-major, recursive," << std::endl;
+    std::cout << "                  adaptive, bareiss, modular" << std::endl;
+    std::cout << "                  (default: unblocked)" << std::endl;
+    std::cout << "  --panel=N       Panel width of the blocked engine (default: 64)" << std::endl;
+    std::cout << "  --tile=N        Tile of the blocked, tiled and tile-major engines (default: 128)" << std::endl;
+    std::cout << "  --threads=N     Worker threads for the trailing updates (default: 1)" << std::endl;
+    std::cout << "  --tolerance=X   Adaptive engine: largest error estimate kept from double (default: 1e-6)" << std::endl;
+    std::cout << "  --bench         Run every engine on the file and compare timings" << std::endl;
+    std::cout << "  --log           Print the sign and natural log of |det| instead of det" << std::endl;
+    std::cout << "  --logical-pivots" << std::endl;
+    std::cout << "                  Unblocked, blocked engines: record row swaps instead of moving rows" << std::endl;
+    std::cout << "  --huge-pages[=thp|explicit]" << std::endl;
+    std::cout << "                  Back the matrix with transparent or reserved 2 MiB pages" << std::endl;
+    std::cout << "  --interleave    Interleave the matrix pages over all NUMA nodes" << std::endl;
+    std::cout << "  --out-of-core=STORE" << std::endl;
+    std::cout << "                  Copy the file into tile store STORE and factor it on disk" << std::endl;
+    std::cout << "  --convert=OUT   Write the matrix to OUT in the binary format and exit" << std::endl;
+    std::cout << "  --exact         Integer input: exact determinant from bareiss, or modular from n = 64" << std::endl;
+    std::cout << "                  (an explicit --engine wins)" << std::endl;
+    std::cout << "  --full-crt      Modular engine: use primes up to the Hadamard bound, no early exit" << std::endl;
+    std::cout << "  --precision=T   Scalar type: float, double, long-double, quad (default: long-double)" << std::endl;
+    std::cout << "Partial pivoting LU decomposition in the chosen precision" << std::endl;
+    std::cout << "(the simd engine works in double precision)" << std::endl;
 }
 
+#define HWMX_INSTANTIATE(T) \
+    template class Matrix<T>; \
+    template class Workspace<T>; \
+    template PivotProduct<T> Engines::unblocked(MatrixView<T>, ThreadPool*, bool, size_t*); \
+    template T DeterminantCalculator::calculateDeterminant(Matrix<T>&); \
+    template T DeterminantCalculator::calculateDeterminant(Matrix<T>&, const Options&); \
+    template T DeterminantCalculator::calculateDeterminant(Matrix<T>&, const Options&, std::vector<size_t>&); \
+    template DeterminantCalculator::LogDeterminant DeterminantCalculator::logDeterminant(Matrix<T>&, const Options&); \
+    template T DeterminantCalculator::calculateDeterminant(MatrixView<T>, const Options&); \
+    template DeterminantCalculator::LogDeterminant DeterminantCalculator::logDeterminant(MatrixView<T>, const Options&); \
+    template BigInteger DeterminantCalculator::calculateExactDeterminant(const Matrix<T>&, const Options&); \
+    template BigInteger DeterminantCalculator::calculateExactDeterminant(MatrixView<const T>, const Options&); \
+    template T DeterminantCalculator::calculateDeterminant(const Matrix<T>&, const Options&, Workspace<T>&); \
+    template T DeterminantCalculator::calculateDeterminant(MatrixView<const T>, const Options&, Workspace<T>&); \
+    template DeterminantCalculator::LogDeterminant DeterminantCalculator::logDeterminant(const Matrix<T>&, const Options&, Workspace<T>&); \
+    template DeterminantCalculator::LogDeterminant DeterminantCalculator::logDeterminant(MatrixView<const T>, const Options&, Workspace<T>&); \
+    template T DeterminantCalculator::calculateBlockedDeterminant(Matrix<T>&, size_t, size_t, size_t); \
+    template double DeterminantCalculator::calculateSimdDeterminant(const Matrix<T>&, size_t); \
+    template T DeterminantCalculator::calculateTiledDeterminant(Matrix<T>&, size_t, size_t); \
+    template T DeterminantCalculator::calculateRecursiveDeterminant(Matrix<T>&); \
+    template Matrix<T> MatrixReader::readFromFile<T>(const std::string&, const AllocationPolicy&, size_t); \
+    template Matrix<T> MatrixReader::readFromUserInput<T>(const AllocationPolicy&);
+HWMX_FOR_EACH_SCALAR(HWMX_INSTANTIATE)
+#undef HWMX_INSTANTIATE
+
 } // namespace LinearAlgebra
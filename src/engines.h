@@ -0,0 +1,116 @@
+// Internal entry points of the LU engines. Each engine reports the product
+// of its pivots as a PivotProduct; determinant.cpp turns that into either
+// the plain determinant or its logarithm.
+
+#ifndef ENGINES_H
+#define ENGINES_H
+
+#include "determinant.h"
+#include "scalar_traits.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace LinearAlgebra 
+{
+
+class ThreadPool;
+
+// Running product of pivots kept as mantissa * 2^exponent with the mantissa
+// renormalized after every step, so no number of pivots can overflow or
+// underflow it. The sign travels with the mantissa, which is kept in the
+// engine's scalar type T so a wider type keeps its extra digits.
+template <typename T>
+class PivotProduct 
+{
+public:
+    void multiply(T pivot) 
+    {
+        int shift = 0;
+        mantissa = ScalarTraits<T>::frexp(mantissa * pivot, &shift);
+        exponent += shift;
+    }
+    
+    void multiply(const PivotProduct& other) 
+    {
+        multiply(other.mantissa);
+        exponent += other.exponent;
+        singular = singular || other.singular;
+    }
+    
+    void multiplyByPowerOfTwo(long power) 
+    {
+        exponent += power;
+    }
+    
+    void negate() 
+    {
+        mantissa = -mantissa;
+    }
+    
+    void markSingular() 
+    {
+        singular = true;
+    }
+    
+    T value() const 
+    {
+        if (singular) return T(0);
+        // Anything beyond int range is far outside every T's range anyway
+        const long clamped = std::max<long>(std::min<long>(exponent, INT_MAX), INT_MIN);
+        return ScalarTraits<T>::ldexp(mantissa, static_cast<int>(clamped));
+    }
+    
+    // The same product with the mantissa rounded to U
+    template <typename U>
+    PivotProduct<U> as() const 
+    {
+        PivotProduct<U> other;
+        other.multiply(static_cast<U>(mantissa));
+        other.multiplyByPowerOfTwo(exponent);
+        if (singular) other.markSingular();
+        return other;
+    }
+    
+    DeterminantCalculator::LogDeterminant logValue() const 
+    {
+        if (singular || mantissa == T(0)) 
+        {
+            return { 0, -std::numeric_limits<long double>::infinity() };
+        }
+        return { mantissa < T(0) ? -1 : 1, 
+                 std::log(std::fabs(static_cast<long double>(mantissa))) + static_cast<long double>(exponent) * 0.693147180559945309417232121458176568L };
+    }
+    
+private:
+    T mantissa = T(1);
+    long exponent = 0;
+    bool singular = false;
+};
+
+namespace Engines 
+{
+    // All engines take a square view and factor it in place, except simd,
+    // which works on a double copy.
+    // permutation, if not null, receives the n-entry row order of the factors;
+    // pool, if not null, runs the parallel loops, otherwise they run serially
+    template <typename T> PivotProduct<T> unblocked(MatrixView<T> matrix, ThreadPool* pool, bool logicalPivoting, size_t* permutation);
+    template <typename T> PivotProduct<T> blocked(MatrixView<T> matrix, size_t panelWidth, size_t tileSize, ThreadPool* pool, 
+                                                  bool logicalPivoting, size_t* permutation);
+    // errorEstimate, if not null, receives an estimate of the relative error
+    // of the double-precision determinant, about u kappa_1(A) times the
+    // pivot growth (infinity when it looks singular)
+    template <typename T> PivotProduct<T> simd(MatrixView<const T> matrix, ThreadPool* pool, double* errorEstimate);
+    template <typename T> PivotProduct<T> tiled(MatrixView<T> matrix, size_t tileSize, size_t threads);
+    template <typename T> PivotProduct<T> tileMajor(MatrixView<const T> matrix, size_t tileSize, size_t threads);
+    // simd first; blocked in ScalarTraits<T>::Escalated precision when the
+    // double estimate exceeds options.adaptiveTolerance
+    template <typename T> PivotProduct<T> adaptive(MatrixView<T> matrix, const DeterminantCalculator::Options& options, ThreadPool* pool);
+    template <typename T> PivotProduct<T> recursive(MatrixView<T> matrix);
+}
+
+} // namespace LinearAlgebra
+
+#endif // ENGINES_H
@@ -0,0 +1,304 @@
+#include "file_matrix.h"
+#include "scalar_traits.h"
+#include "text_parser.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace LinearAlgebra 
+{
+
+namespace 
+{
+
+constexpr char kMagic[8] = { 'H', 'W', 'M', 'X', 'T', 'I', 'L', 'E' };
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderBytes = 64;
+
+struct StoreHeader 
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t scalar;        // scalarTag of the element type
+    uint64_t elementBytes;
+    uint64_t size;
+    uint64_t tileSize;
+    uint8_t reserved[24];
+};
+static_assert(sizeof(StoreHeader) == kHeaderBytes, "Tile store header must be 64 bytes");
+
+std::runtime_error ioError(const std::string& what) 
+{ 
+    return std::runtime_error(what + ": " + std::strerror(errno)); 
+}
+
+} // namespace
+
+template <typename T>
+FileMatrix<T>::FileMatrix(int fd, size_t size, size_t tileSize)
+    : fd(fd), size(size), tileSize(tileSize), tiles((size + tileSize - 1) / tileSize) 
+{
+}
+
+template <typename T>
+FileMatrix<T>::FileMatrix(FileMatrix&& other) noexcept
+    : fd(other.fd), size(other.size), tileSize(other.tileSize), tiles(other.tiles) 
+{ 
+    other.fd = -1; 
+}
+
+template <typename T>
+FileMatrix<T>& FileMatrix<T>::operator=(FileMatrix&& other) noexcept 
+{
+    if (this != &other) 
+    {
+        if (fd >= 0) ::close(fd);
+        fd = other.fd;
+        size = other.size;
+        tileSize = other.tileSize;
+        tiles = other.tiles;
+        other.fd = -1;
+    }
+    return *this;
+}
+
+template <typename T>
+FileMatrix<T>::~FileMatrix() 
+{ 
+    if (fd >= 0) ::close(fd); 
+}
+
+template <typename T>
+FileMatrix<T> FileMatrix<T>::create(const std::string& path, size_t n, size_t tileSize) 
+{
+    if (tileSize == 0) 
+    {
+        throw std::invalid_argument("Block sizes must be positive");
+    }
+    
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) 
+    {
+        throw ioError("Cannot create tile store " + path);
+    }
+    FileMatrix matrix(fd, n, tileSize);
+    
+    StoreHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.scalar = scalarTag<T>();
+    header.elementBytes = sizeof(T);
+    header.size = n;
+    header.tileSize = tileSize;
+    matrix.transfer(0, sizeof(header), &header, true);
+    
+    // Extending the file leaves a hole that reads back as zeros
+    if (::ftruncate(fd, static_cast<off_t>(matrix.offset(0, matrix.tiles))) != 0) 
+    {
+        throw ioError("Cannot size tile store " + path);
+    }
+    return matrix;
+}
+
+template <typename T>
+FileMatrix<T> FileMatrix<T>::open(const std::string& path) 
+{
+    const int fd = ::open(path.c_str(), O_RDWR);
+    if (fd < 0) 
+    {
+        throw ioError("Cannot open tile store " + path);
+    }
+    
+    StoreHeader header{};
+    if (::pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+        std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) 
+    {
+        ::close(fd);
+        throw std::runtime_error("Not a tile store: " + path);
+    }
+    if (header.scalar != scalarTag<T>() || header.elementBytes != sizeof(T) || header.tileSize == 0) 
+    {
+        ::close(fd);
+        throw std::runtime_error("Tile store " + path + " holds another element type");
+    }
+    return FileMatrix(fd, header.size, header.tileSize);
+}
+
+template <typename T>
+FileMatrix<T> FileMatrix<T>::fromMatrix(const std::string& path, MatrixView<const T> matrix, size_t tileSize) 
+{
+    if (!matrix.isSquare()) 
+    {
+        throw std::invalid_argument("Tile store of a non-square view");
+    }
+    
+    FileMatrix store = create(path, matrix.getSize(), tileSize);
+    const size_t n = store.size;
+    std::vector<T> tile(tileSize * tileSize);
+    
+    for (size_t tj = 0; tj < store.tiles; ++tj) 
+    {
+        for (size_t ti = 0; ti < store.tiles; ++ti) 
+        {
+            std::fill(tile.begin(), tile.end(), T(0));
+            for (size_t i = ti * tileSize; i < std::min(n, (ti + 1) * tileSize); ++i) 
+            {
+                for (size_t j = tj * tileSize; j < std::min(n, (tj + 1) * tileSize); ++j) 
+                {
+                    tile[(i - ti * tileSize) * tileSize + j - tj * tileSize] = matrix(i, j);
+                }
+            }
+            store.writeTile(ti, tj, tile.data());
+        }
+    }
+    return store;
+}
+
+template <typename T>
+FileMatrix<T> FileMatrix<T>::importText(const std::string& textPath, const std::string& path, size_t tileSize) 
+{
+    using Parsed = typename ScalarTraits<T>::Parsed;
+    
+    if (MatrixReader::isBinary(textPath) || MatrixReader::isNumpy(textPath)) 
+    {
+        throw std::invalid_argument("Not a text matrix: " + textPath + " (use fromMatrix with MatrixReader::readFromFile)");
+    }
+    
+    TextParser::LineSource source(textPath);
+    const char* line = nullptr;
+    const char* end = nullptr;
+    
+    // The first row gives the order; it is kept and stored with its row tile
+    std::vector<Parsed> first;
+    if (source.nextLine(line, end)) 
+    {
+        Parsed entry;
+        while (TextParser::parseValue(line, end, entry)) 
+        {
+            first.push_back(entry);
+        }
+    }
+    const size_t n = first.size();
+    
+    FileMatrix store = create(path, n, tileSize);
+    
+    // One row tile: tileSize rows, split into the tiles of that tile row
+    std::vector<T> rows(tileSize * store.tiles * tileSize);
+    for (size_t ti = 0; ti < store.tiles; ++ti) 
+    {
+        std::fill(rows.begin(), rows.end(), T(0));
+        const size_t count = std::min(tileSize, n - ti * tileSize);
+        
+        for (size_t r = 0; r < count; ++r) 
+        {
+            if (ti == 0 && r == 0) 
+            {
+                for (size_t j = 0; j < n; ++j) 
+                {
+                    rows[(j / tileSize) * tileSize * tileSize + j % tileSize] = static_cast<T>(first[j]);
+                }
+                continue;
+            }
+            if (!source.nextLine(line, end)) 
+            {
+                throw std::runtime_error("Invalid matrix format: not enough rows");
+            }
+            
+            for (size_t j = 0; j < n; ++j) 
+            {
+                Parsed entry;
+                if (!TextParser::parseValue(line, end, entry)) 
+                {
+                    throw std::runtime_error("Invalid matrix format: not enough columns");
+                }
+                // Stored tile by tile: tile tj of this row tile starts at tj * b * b
+                rows[(j / tileSize) * tileSize * tileSize + r * tileSize + j % tileSize] = static_cast<T>(entry);
+            }
+        }
+        
+        for (size_t tj = 0; tj < store.tiles; ++tj) 
+        {
+            store.writeTile(ti, tj, rows.data() + tj * tileSize * tileSize);
+        }
+    }
+    return store;
+}
+
+template <typename T>
+size_t FileMatrix<T>::getSize() const 
+{ 
+    return size; 
+}
+
+template <typename T>
+size_t FileMatrix<T>::getTileSize() const 
+{ 
+    return tileSize; 
+}
+
+template <typename T>
+size_t FileMatrix<T>::getTileCount() const 
+{ 
+    return tiles; 
+}
+
+template <typename T>
+uint64_t FileMatrix<T>::offset(size_t row, size_t column) const 
+{ 
+    return kHeaderBytes + (static_cast<uint64_t>(column) * tiles + row) * tileSize * tileSize * sizeof(T); 
+}
+
+template <typename T>
+void FileMatrix<T>::transfer(uint64_t position, size_t bytes, void* buffer, bool write) const 
+{
+    char* cursor = static_cast<char*>(buffer);
+    while (bytes > 0) 
+    {
+        const ssize_t done = write ? ::pwrite(fd, cursor, bytes, static_cast<off_t>(position))
+                                   : ::pread(fd, cursor, bytes, static_cast<off_t>(position));
+        if (done < 0 && errno == EINTR) continue;
+        if (done <= 0) 
+        {
+            throw ioError(write ? "Tile store write failed" : "Tile store read failed");
+        }
+        cursor += done;
+        position += static_cast<uint64_t>(done);
+        bytes -= static_cast<size_t>(done);
+    }
+}
+
+template <typename T>
+void FileMatrix<T>::readTiles(size_t column, size_t firstTile, T* out) const 
+{ 
+    transfer(offset(firstTile, column), (tiles - firstTile) * tileSize * tileSize * sizeof(T), out, false); 
+}
+
+template <typename T>
+void FileMatrix<T>::writeTiles(size_t column, size_t firstTile, const T* in) 
+{ 
+    transfer(offset(firstTile, column), (tiles - firstTile) * tileSize * tileSize * sizeof(T), const_cast<T*>(in), true); 
+}
+
+template <typename T>
+void FileMatrix<T>::readTile(size_t row, size_t column, T* out) const 
+{ 
+    transfer(offset(row, column), tileSize * tileSize * sizeof(T), out, false); 
+}
+
+template <typename T>
+void FileMatrix<T>::writeTile(size_t row, size_t column, const T* in) 
+{ 
+    transfer(offset(row, column), tileSize * tileSize * sizeof(T), const_cast<T*>(in), true); 
+}
+
+#define HWMX_INSTANTIATE(T) \
+    template class FileMatrix<T>;
+HWMX_FOR_EACH_SCALAR(HWMX_INSTANTIATE)
+#undef HWMX_INSTANTIATE
+
+} // namespace LinearAlgebra
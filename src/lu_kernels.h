@@ -0,0 +1,126 @@
+// Building blocks shared by the blocked, tiled and recursive LU engines,
+// templated on the matrix scalar type.
+// All matrices are row-major with an explicit leading dimension.
+
+#ifndef LU_KERNELS_H
+#define LU_KERNELS_H
+
+#include <cstddef>
+
+namespace LinearAlgebra 
+{
+
+namespace LuKernels 
+{
+
+// packed[j * depth + p] = u[p * ldu + j] for a depth x cols block, so that
+// both operands of the inner product in multiplySubtract are contiguous.
+template <typename T>
+inline void packTransposed(const T* u, size_t ldu, size_t depth, size_t cols, T* packed) 
+{
+    for (size_t j = 0; j < cols; ++j) 
+    {
+        T* col = packed + j * depth;
+        for (size_t p = 0; p < depth; ++p) 
+        {
+            col[p] = u[p * ldu + j];
+        }
+    }
+}
+
+// C[rows x cols] -= L[rows x depth] * U, with U given by packTransposed.
+// Goes through a 2x2 register block: with 80-bit elements the limiting
+// factor is memory operations per multiply-add, not arithmetic.
+template <typename T>
+inline void multiplySubtract(T* c, size_t ldc, const T* l, size_t ldl, 
+                             const T* packed, size_t rows, size_t cols, size_t depth) 
+{
+    size_t i = 0;
+    for (; i + 1 < rows; i += 2) 
+    {
+        T* row_0 = c + i * ldc;
+        T* row_1 = row_0 + ldc;
+        const T* l_0 = l + i * ldl;
+        const T* l_1 = l_0 + ldl;
+        
+        size_t j = 0;
+        for (; j + 1 < cols; j += 2) 
+        {
+            const T* u_0 = packed + j * depth;
+            const T* u_1 = u_0 + depth;
+            T c00 = T(0), c01 = T(0), c10 = T(0), c11 = T(0);
+            
+            for (size_t p = 0; p < depth; ++p) 
+            {
+                c00 += l_0[p] * u_0[p];
+                c01 += l_0[p] * u_1[p];
+                c10 += l_1[p] * u_0[p];
+                c11 += l_1[p] * u_1[p];
+            }
+            
+            row_0[j] -= c00;
+            row_0[j + 1] -= c01;
+            row_1[j] -= c10;
+            row_1[j + 1] -= c11;
+        }
+        for (; j < cols; ++j) 
+        {
+            const T* u_0 = packed + j * depth;
+            T c0 = T(0), c1 = T(0);
+            
+            for (size_t p = 0; p < depth; ++p) 
+            {
+                c0 += l_0[p] * u_0[p];
+                c1 += l_1[p] * u_0[p];
+            }
+            
+            row_0[j] -= c0;
+            row_1[j] -= c1;
+        }
+    }
+    for (; i < rows; ++i) 
+    {
+        T* row_i = c + i * ldc;
+        const T* l_i = l + i * ldl;
+        
+        for (size_t j = 0; j < cols; ++j) 
+        {
+            const T* u_j = packed + j * depth;
+            T acc = T(0);
+            
+            for (size_t p = 0; p < depth; ++p) 
+            {
+                acc += l_i[p] * u_j[p];
+            }
+            
+            row_i[j] -= acc;
+        }
+    }
+}
+
+// B[depth x cols] = L^-1 * B, L the unit lower triangle of a depth x depth block
+template <typename T>
+inline void solveUnitLower(const T* l, size_t ldl, T* b, size_t ldb, size_t depth, size_t cols) 
+{
+    for (size_t i = 1; i < depth; ++i) 
+    {
+        T* row_i = b + i * ldb;
+        
+        for (size_t p = 0; p < i; ++p) 
+        {
+            const T factor = l[i * ldl + p];
+            const T* row_p = b + p * ldb;
+            
+            for (size_t j = 0; j < cols; ++j) 
+            {
+                row_i[j] -= factor * row_p[j];
+            }
+        }
+    }
+}
+
+} // namespace LuKernels
+
+} // namespace LinearAlgebra
+
+#endif // LU_KERNELS_H
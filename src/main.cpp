@@ -1,51 +1,370 @@
 #include <iostream>
 #include <chrono>
+#include <string>
+#include <iomanip>
+#include <stdexcept>
 #include "determinant.h"
+#include "simd_kernels.h"
+#include "big_integer.h"
+#include "file_matrix.h"
 
 using namespace LinearAlgebra;
 
-int main(int argc, char* argv[]) 
+// With --exact, integer matrices at least this large go to the modular engine
+constexpr size_t kModularThreshold = 64;
+
+static size_t parseSize(const std::string& option, const std::string& value) 
 {
+    size_t parsed = 0;
     try 
     {
-        Matrix matrix(0);
+        parsed = std::stoul(value);
+    } 
+    catch (const std::exception&) 
+    {
+        throw std::invalid_argument("Invalid value for " + option + ": " + value);
+    }
+    if (parsed == 0) 
+    {
+        throw std::invalid_argument("Invalid value for " + option + ": " + value);
+    }
+    return parsed;
+}
+
+static double parseTolerance(const std::string& option, const std::string& value) 
+{
+    double parsed = 0.0;
+    try 
+    {
+        parsed = std::stod(value);
+    } 
+    catch (const std::exception&) 
+    {
+        throw std::invalid_argument("Invalid value for " + option + ": " + value);
+    }
+    if (!(parsed > 0.0)) 
+    {
+        throw std::invalid_argument("Invalid value for " + option + ": " + value);
+    }
+    return parsed;
+}
+
+// Runs every LU engine on its own copy of the matrix and prints one row per
+// engine, with the speedup over the classic unblocked loop
+template <typename T>
+static void runBenchmark(const Matrix<T>& matrix, const DeterminantCalculator::Options& options) 
+{
+    using DeterminantCalculator::Engine;
+    const Engine engines[] = 
+    {
+        Engine::Unblocked, Engine::Blocked, Engine::Recursive, Engine::Tiled, Engine::TileMajor, Engine::Simd, Engine::Adaptive, Engine::Bareiss, Engine::Modular
+    };
+    
+    double baseline = 0.0;
+    std::cout << std::left << std::setw(12) << "engine" << std::right << std::setw(14) << "time [ms]"
+              << std::setw(10) << "speedup" << "  determinant" << std::endl;
+    
+    for (Engine engine : engines) 
+    {
+        if ((engine == Engine::Bareiss || engine == Engine::Modular) && !matrix.isIntegral()) continue;
+        
+        DeterminantCalculator::Options run = options;
+        run.engine = engine;
+        Matrix<T> work = matrix.copy();
+        
+        auto start_time = std::chrono::high_resolution_clock::now();
+        long double determinant = static_cast<long double>(DeterminantCalculator::calculateDeterminant(work, run));
+        auto calc_time = std::chrono::high_resolution_clock::now();
+        
+        const double ms = std::chrono::duration<double, std::milli>(calc_time - start_time).count();
+        if (engine == Engine::Unblocked) baseline = ms;
+        
+        std::cout << std::left << std::setw(12) << DeterminantCalculator::engineName(engine) << std::right
+                  << std::fixed << std::setprecision(2) << std::setw(14) << ms
+                  << std::setw(9) << (ms > 0.0 ? baseline / ms : 0.0) << "x"
+                  << std::defaultfloat << std::setprecision(12) << "  " << determinant << std::endl;
+    }
+}
+
+// Computes and prints the determinant; labelled output is used for the
+// interactive mode, bare values for files so the output can be piped
+template <typename T>
+static void computeAndPrint(Matrix<T>& matrix, const DeterminantCalculator::Options& options, bool logarithm, bool labelled) 
+{
+    using DeterminantCalculator::Engine;
+    
+    // The clock stops as soon as the engine returns; printing is not timed
+    auto start_time = std::chrono::high_resolution_clock::now();
+    std::chrono::high_resolution_clock::time_point calc_time;
+    if (logarithm) 
+    {
+        DeterminantCalculator::LogDeterminant result = DeterminantCalculator::logDeterminant(matrix, options);
+        calc_time = std::chrono::high_resolution_clock::now();
+        
+        if (labelled) std::cout << "Sign: " << result.sign << ", log|det|: ";
+        else std::cout << result.sign << " ";
+        std::cout << std::setprecision(17) << result.logAbs << std::endl;
+    }
+    else if (options.engine == Engine::Bareiss || options.engine == Engine::Modular) 
+    {
+        BigInteger determinant = DeterminantCalculator::calculateExactDeterminant(matrix, options);
+        calc_time = std::chrono::high_resolution_clock::now();
+        
+        if (labelled) std::cout << "Determinant: ";
+        std::cout << determinant.toString() << std::endl;
+    }
+    else 
+    {
+        double determinant = static_cast<double>(DeterminantCalculator::calculateDeterminant(matrix, options));
+        calc_time = std::chrono::high_resolution_clock::now();
         
-        if (argc == 2) 
+        if (labelled) std::cout << "Determinant: ";
+        std::cout << determinant << std::endl;
+    }
+    
+    auto calc_duration = std::chrono::duration_cast<std::chrono::microseconds>(calc_time - start_time);
+    std::cerr << "Calculation time: " << calc_duration.count() << " μs" << std::endl;
+}
+
+// Import into the tile store is reported apart from the factorization, so
+// "Calculation time" stays comparable with the in-memory engines
+template <typename Clock>
+static void reportOutOfCoreTimes(Clock start_time, Clock import_time, Clock calc_time) 
+{
+    auto import_duration = std::chrono::duration_cast<std::chrono::microseconds>(import_time - start_time);
+    auto calc_duration = std::chrono::duration_cast<std::chrono::microseconds>(calc_time - import_time);
+    std::cerr << "Import time: " << import_duration.count() << " μs" << std::endl;
+    std::cerr << "Calculation time: " << calc_duration.count() << " μs" << std::endl;
+}
+
+// Text is imported row tile by row tile. Binary and .npy files are mapped
+// and copied over from the mapping, whose pages stay clean, evictable page
+// cache (a .npy file of another element type is converted in memory first).
+template <typename T>
+static FileMatrix<T> importStore(const std::string& filename, const std::string& store, size_t tileSize) 
+{
+    if (MatrixReader::isBinary(filename) || MatrixReader::isNumpy(filename)) 
+    {
+        const Matrix<T> mapped = MatrixReader::readFromFile<T>(filename);
+        return FileMatrix<T>::fromMatrix(store, mapped.view(), tileSize);
+    }
+    return FileMatrix<T>::importText(filename, store, tileSize);
+}
+
+// Streams the matrix into a tile store and factors it there; nothing
+// larger than a few tile columns is ever held in memory
+template <typename T>
+static void runOutOfCore(const std::string& filename, const std::string& store, 
+                         const DeterminantCalculator::Options& options, bool logarithm) 
+{
+    auto start_time = std::chrono::high_resolution_clock::now();
+    FileMatrix<T> matrix = importStore<T>(filename, store, options.tileSize);
+    auto import_time = std::chrono::high_resolution_clock::now();
+    
+    if (logarithm) 
+    {
+        DeterminantCalculator::LogDeterminant result = DeterminantCalculator::logOutOfCoreDeterminant(matrix, options.threads);
+        auto calc_time = std::chrono::high_resolution_clock::now();
+        std::cout << result.sign << " " << std::setprecision(17) << result.logAbs << std::endl;
+        reportOutOfCoreTimes(start_time, import_time, calc_time);
+    }
+    else 
+    {
+        double determinant = static_cast<double>(DeterminantCalculator::calculateOutOfCoreDeterminant(matrix, options.threads));
+        auto calc_time = std::chrono::high_resolution_clock::now();
+        std::cout << determinant << std::endl;
+        reportOutOfCoreTimes(start_time, import_time, calc_time);
+    }
+    
+    std::cerr << "Matrix size: " << matrix.getSize() << "x" << matrix.getSize() << std::endl;
+    std::cerr << "Out of core, tile store " << store << std::endl;
+}
+
+// Reads the matrix in scalar type T and runs the requested mode on it
+template <typename T>
+static int run(const std::string& programName, const std::string& filename, DeterminantCalculator::Options options, 
+               AllocationPolicy policy, const std::string& store, const std::string& converted, bool benchmark, bool logarithm, 
+               bool exact) 
+{
+    if (!converted.empty()) 
+    {
+        if (filename.empty()) 
         {
-            // Read from file
-            matrix = MatrixReader::readFromFile(argv[1]);
-            auto read_time = std::chrono::high_resolution_clock::now();
-            
-            double determinant = DeterminantCalculator::calculateDeterminant(matrix);
-            auto calc_time = std::chrono::high_resolution_clock::now();
-            
-            std::cout << determinant << std::endl;
-            
-            auto calc_duration = std::chrono::duration_cast<std::chrono::microseconds>(calc_time - read_time);
-            
-            std::cerr << "Calculation time: " << calc_duration.count() << " μs" << std::endl;
+            printUsage(programName);
+            return 1;
         }
-        else if (argc == 1) 
+        const Matrix<T> matrix = MatrixReader::readFromFile<T>(filename, policy, options.threads);
+        MatrixWriter::writeBinary(converted, matrix);
+        std::cerr << "Wrote " << matrix.getSize() << "x" << matrix.getSize() << " binary matrix " << converted << std::endl;
+        return 0;
+    }
+    
+    if (!store.empty()) 
+    {
+        if (filename.empty()) 
         {
-            matrix = MatrixReader::readFromUserInput();
-            
-            auto start_time = std::chrono::high_resolution_clock::now();
-            double determinant = DeterminantCalculator::calculateDeterminant(matrix);
-            auto calc_time = std::chrono::high_resolution_clock::now();
-            
-            std::cout << "Determinant: " << determinant << std::endl;
-            
-            auto calc_duration = std::chrono::duration_cast<std::chrono::microseconds>(calc_time - start_time);
-            std::cerr << "Calculation time: " << calc_duration.count() << " μs" << std::endl;
+            printUsage(programName);
+            return 1;
         }
-        else 
+        runOutOfCore<T>(filename, store, options, logarithm);
+        return 0;
+    }
+    
+    // Benchmark copies go back to the pool between engines; the matrix is
+    // first touched by as many threads as will work on it, tile by tile
+    policy.pool = &BufferPool::shared();
+    policy.firstTouchThreads = options.threads;
+    policy.firstTouchRows = options.tileSize;
+    Matrix<T> matrix(0);
+    
+    if (benchmark) 
+    {
+        if (filename.empty()) 
         {
-            printUsage(argv[0]);
+            printUsage(programName);
             return 1;
         }
+        matrix = MatrixReader::readFromFile<T>(filename, policy, options.threads);
+        runBenchmark(matrix, options);
+    }
+    else 
+    {
+        // Read from file, or ask for the matrix when no file was given
+        matrix = filename.empty() ? MatrixReader::readFromUserInput<T>(policy) : MatrixReader::readFromFile<T>(filename, policy, options.threads);
         
-        std::cerr << "Matrix size: " << matrix.getSize() << "x" << matrix.getSize() << std::endl;
+        // --exact sends integer input to an exact engine: Bareiss while
+        // its 64-bit pass is cheap, CRT for larger matrices
+        if (exact && matrix.isIntegral()) 
+        {
+            options.engine = matrix.getSize() < kModularThreshold 
+                ? DeterminantCalculator::Engine::Bareiss 
+                : DeterminantCalculator::Engine::Modular;
+        }
+        
+        computeAndPrint(matrix, options, logarithm, filename.empty());
+    }
+    
+    std::cerr << "Matrix size: " << matrix.getSize() << "x" << matrix.getSize() << std::endl;
+    if (options.engine == DeterminantCalculator::Engine::Simd) 
+    {
+        std::cerr << "SIMD kernels: " << Simd::kernels().name << std::endl;
+    }
+    if (options.engine == DeterminantCalculator::Engine::Bareiss) 
+    {
+        std::cerr << "Exact integer arithmetic (Bareiss)" << std::endl;
+    }
+    if (options.engine == DeterminantCalculator::Engine::Modular) 
+    {
+        std::cerr << "Exact integer arithmetic (multi-modular CRT)" << std::endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) 
+{
+    try 
+    {
+        DeterminantCalculator::Options options;
+        std::string filename;
+        std::string precision = "long-double";
+        AllocationPolicy policy;
+        std::string store;
+        std::string converted;
+        bool benchmark = false;
+        bool logarithm = false;
+        bool engineChosen = false;
+        bool exact = false;
+        
+        for (int arg = 1; arg < argc; ++arg) 
+        {
+            const std::string value = argv[arg];
+            const size_t eq = value.find('=');
+            const std::string key = value.substr(0, eq);
+            const std::string param = eq == std::string::npos ? "" : value.substr(eq + 1);
+            
+            if (key == "--engine") 
+            {
+                options.engine = DeterminantCalculator::parseEngine(param);
+                engineChosen = true;
+            }
+            else if (key == "--panel") 
+            {
+                options.panelWidth = parseSize(key, param);
+            }
+            else if (key == "--tile") 
+            {
+                options.tileSize = parseSize(key, param);
+            }
+            else if (key == "--threads") 
+            {
+                options.threads = parseSize(key, param);
+            }
+            else if (key == "--tolerance") 
+            {
+                options.adaptiveTolerance = parseTolerance(key, param);
+            }
+            else if (key == "--precision") 
+            {
+                precision = param;
+            }
+            else if (key == "--huge-pages") 
+            {
+                if (param.empty() || param == "thp") policy.hugePages = HugePages::Transparent;
+                else if (param == "explicit") policy.hugePages = HugePages::Explicit;
+                else throw std::invalid_argument("Invalid value for --huge-pages: " + param);
+            }
+            else if (value == "--interleave") 
+            {
+                policy.numa = NumaPlacement::Interleave;
+            }
+            else if (key == "--out-of-core") 
+            {
+                if (param.empty()) throw std::invalid_argument("--out-of-core needs a tile store path");
+                store = param;
+            }
+            else if (key == "--convert") 
+            {
+                if (param.empty()) throw std::invalid_argument("--convert needs an output path");
+                converted = param;
+            }
+            else if (value == "--bench") 
+            {
+                benchmark = true;
+            }
+            else if (value == "--log") 
+            {
+                logarithm = true;
+            }
+            else if (value == "--logical-pivots") 
+            {
+                options.logicalPivoting = true;
+            }
+            else if (value == "--exact") 
+            {
+                exact = true;
+            }
+            else if (value == "--full-crt") 
+            {
+                options.earlyTermination = false;
+            }
+            else if (value.rfind("--", 0) == 0 || !filename.empty()) 
+            {
+                printUsage(argv[0]);
+                return 1;
+            }
+            else 
+            {
+                filename = value;
+            }
+        }
         
+        if (precision == "float") return run<float>(argv[0], filename, options, policy, store, converted, benchmark, logarithm, exact && !engineChosen);
+        if (precision == "double") return run<double>(argv[0], filename, options, policy, store, converted, benchmark, logarithm, exact && !engineChosen);
+        if (precision == "long-double") return run<long double>(argv[0], filename, options, policy, store, converted, benchmark, logarithm, exact && !engineChosen);
+#ifdef __SIZEOF_FLOAT128__
+        if (precision == "quad") return run<__float128>(argv[0], filename, options, policy, store, converted, benchmark, logarithm, exact && !engineChosen);
+#endif
+        throw std::invalid_argument("Unsupported precision: " + precision);
     } 
     catch (const std::exception& e) 
     {
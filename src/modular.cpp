@@ -0,0 +1,312 @@
+#include "determinant.h"
+#include "big_integer.h"
+#include "thread_pool.h"
+#include "scalar_traits.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+namespace LinearAlgebra 
+{
+
+namespace 
+{
+
+using u64 = uint64_t;
+using u128 = unsigned __int128;
+
+u64 mulMod(u64 a, u64 b, u64 p) 
+{ 
+    return static_cast<u64>(static_cast<u128>(a) * b % p); 
+}
+
+u64 powMod(u64 base, u64 exponent, u64 p) 
+{
+    u64 result = 1 % p;
+    base %= p;
+    while (exponent) 
+    {
+        if (exponent & 1) result = mulMod(result, base, p);
+        base = mulMod(base, base, p);
+        exponent >>= 1;
+    }
+    return result;
+}
+
+// Deterministic Miller-Rabin; these bases cover every 64-bit integer
+bool isPrime(u64 n) 
+{
+    if (n < 2) return false;
+    for (u64 small : {2ull, 3ull, 5ull, 7ull, 11ull, 13ull, 17ull, 19ull, 23ull, 29ull, 31ull, 37ull}) 
+    {
+        if (n % small == 0) return n == small;
+    }
+    
+    u64 d = n - 1;
+    int s = 0;
+    while ((d & 1) == 0) 
+    {
+        d >>= 1;
+        ++s;
+    }
+    
+    for (u64 a : {2ull, 3ull, 5ull, 7ull, 11ull, 13ull, 17ull, 19ull, 23ull, 29ull, 31ull, 37ull}) 
+    {
+        u64 x = powMod(a, d, n);
+        if (x == 1 || x == n - 1) continue;
+        
+        bool composite = true;
+        for (int r = 1; r < s && composite; ++r) 
+        {
+            x = mulMod(x, x, n);
+            composite = x != n - 1;
+        }
+        if (composite) return false;
+    }
+    return true;
+}
+
+// Distinct primes drawn uniformly from [2^61, 2^62), freshly seeded per
+// run so that no fixed input can be built against the sequence
+class RandomPrimes 
+{
+public:
+    u64 next() 
+    {
+        std::uniform_int_distribution<u64> range(1ull << 60, (1ull << 61) - 1);
+        u64 candidate;
+        do 
+        {
+            candidate = 2 * range(random) + 1;
+        } while (!isPrime(candidate) || !used.insert(candidate).second);
+        return candidate;
+    }
+    
+private:
+    std::mt19937_64 random{ (static_cast<u64>(std::random_device{}()) << 32) ^ std::random_device{}() };
+    std::unordered_set<u64> used;
+};
+
+// Arithmetic modulo an odd p < 2^62 in Montgomery form (R = 2^64), which
+// replaces the 128-by-64-bit division of a plain mulMod with two multiplies
+struct Montgomery 
+{
+    explicit Montgomery(u64 p) : p(p), r2(static_cast<u64>((static_cast<u128>(1) << 64) % p)) 
+    {
+        // Newton iteration for p^-1 mod 2^64; each step doubles the correct bits
+        u64 inverse = p;
+        for (int i = 0; i < 5; ++i) 
+        {
+            inverse *= 2 - p * inverse;
+        }
+        negInverse = 0 - inverse;
+        r2 = mulMod(r2, r2, p);
+    }
+    
+    u64 reduce(u128 t) const 
+    {
+        const u64 m = static_cast<u64>(t) * negInverse;
+        const u64 result = static_cast<u64>((t + static_cast<u128>(m) * p) >> 64);
+        return result >= p ? result - p : result;
+    }
+    
+    u64 multiply(u64 a, u64 b) const { return reduce(static_cast<u128>(a) * b); }
+    u64 toForm(u64 a) const { return multiply(a, r2); }
+    u64 fromForm(u64 a) const { return reduce(a); }
+    
+    u64 p;
+    u64 r2;           // R^2 mod p
+    u64 negInverse;   // -p^-1 mod R
+};
+
+// det(A) mod p by Gaussian elimination over GF(p)
+u64 determinantModulo(const std::vector<long long>& source, size_t n, u64 p) 
+{
+    const Montgomery field(p);
+    
+    std::vector<u64> m(n * n);
+    for (size_t i = 0; i < n * n; ++i) 
+    {
+        const long long value = source[i];
+        const u64 magnitude = value < 0 ? 0 - static_cast<u64>(value) : static_cast<u64>(value);
+        const u64 residue = magnitude % p;
+        m[i] = field.toForm(value < 0 && residue ? p - residue : residue);
+    }
+    
+    u64 det = field.toForm(1);
+    for (size_t k = 0; k < n; ++k) 
+    {
+        size_t pivot_row = k;
+        while (pivot_row < n && m[pivot_row * n + k] == 0) 
+        {
+            ++pivot_row;
+        }
+        if (pivot_row == n) return 0;
+        
+        if (pivot_row != k) 
+        {
+            std::swap_ranges(m.begin() + k * n + k, m.begin() + k * n + n, m.begin() + pivot_row * n + k);
+            det = p - det;
+        }
+        
+        const u64 pivot = m[k * n + k];
+        det = field.multiply(det, pivot);
+        const u64 inverse = field.toForm(powMod(field.fromForm(pivot), p - 2, p));
+        
+        for (size_t i = k + 1; i < n; ++i) 
+        {
+            const u64 factor = field.multiply(m[i * n + k], inverse);
+            if (factor == 0) continue;
+            
+            const u64* row_k = m.data() + k * n;
+            u64* row_i = m.data() + i * n;
+            for (size_t j = k + 1; j < n; ++j) 
+            {
+                const u64 t = field.multiply(factor, row_k[j]);
+                row_i[j] = row_i[j] >= t ? row_i[j] - t : row_i[j] + p - t;
+            }
+        }
+    }
+    return field.fromForm(det);
+}
+
+// log2 of Hadamard's bound prod_i ||row_i||_2, which caps |det(A)|
+long double hadamardLog2(const std::vector<long long>& m, size_t n) 
+{
+    long double bound = 0.0L;
+    for (size_t i = 0; i < n; ++i) 
+    {
+        long double norm = 0.0L;
+        for (size_t j = 0; j < n; ++j) 
+        {
+            const long double value = static_cast<long double>(m[i * n + j]);
+            norm += value * value;
+        }
+        if (norm == 0.0L) return -1.0L;
+        bound += 0.5L * std::log2(norm);
+    }
+    return bound;
+}
+
+} // namespace
+
+template <typename T>
+BigInteger DeterminantCalculator::calculateModularDeterminant(MatrixView<const T> matrix, size_t threads, bool earlyTermination) 
+{
+    if (!matrix.isSquare()) 
+    {
+        throw std::invalid_argument("Determinant of a non-square view");
+    }
+    
+    const size_t n = matrix.getSize();
+    
+    if (n == 0) return BigInteger(1);
+    
+    std::vector<long long> entries(n * n);
+    for (size_t i = 0; i < n; ++i) 
+    {
+        for (size_t j = 0; j < n; ++j) 
+        {
+            const long double value = static_cast<long double>(matrix(i, j));
+            if (!std::isfinite(value) || std::trunc(value) != value || std::fabs(value) >= 9223372036854775808.0L) 
+            {
+                throw std::invalid_argument("Modular engine requires integer entries within the int64 range");
+            }
+            entries[i * n + j] = static_cast<long long>(value);
+        }
+    }
+    
+    // A zero row means det = 0; otherwise the product of the primes must
+    // exceed 2 * bound so the symmetric residue is the determinant itself
+    const long double bound = hadamardLog2(entries, n);
+    if (bound < 0.0L) return BigInteger(0);
+    
+    const size_t batch = std::max<size_t>(threads, 1);
+    ThreadPool pool(batch);
+    RandomPrimes primes;
+    
+    BigInteger value(0);    // symmetric representative modulo `modulus`
+    BigInteger modulus(1);
+    long double covered = 0.0L;   // log2(modulus)
+    size_t stable = 0;
+    
+    // Residues that have not changed the reconstruction for this many
+    // consecutive primes are taken as final. A wrong reconstruction differs
+    // from det(A) by a nonzero D with |D| < 2^(bound + covered + 1), which
+    // has fewer than (bound + covered + 1) / 61 prime factors out of the
+    // ~2^55 primes in [2^61, 2^62), so each random prime exposes it except
+    // with probability below (bound + covered + 1) * 2^-61: two of them
+    // leave less than 2^-80 for any matrix whose bound is under 2^20 bits.
+    constexpr size_t kStableRequired = 2;
+    
+    std::vector<u64> batchPrimes(batch);
+    std::vector<u64> residues(batch);
+    
+    while (covered <= bound + 1.0L) 
+    {
+        for (u64& p : batchPrimes) 
+        {
+            p = primes.next();
+        }
+        
+        // One prime per core: each elimination is independent
+        pool.parallelFor(batch, [&](size_t chunk, size_t) 
+        {
+            residues[chunk] = determinantModulo(entries, n, batchPrimes[chunk]);
+        });
+        
+        for (size_t t = 0; t < batch; ++t) 
+        {
+            const u64 p = batchPrimes[t];
+            const u64 r = residues[t];
+            
+            // Incremental CRT: value += modulus * ((r - value) / modulus mod p)
+            const u64 current = value.modulo(p);
+            if (current == r) 
+            {
+                ++stable;
+            }
+            else 
+            {
+                stable = 0;
+                const u64 difference = r >= current ? r - current : r + p - current;
+                const u64 inverse = powMod(modulus.modulo(p), p - 2, p);
+                value += modulus * BigInteger(static_cast<long long>(mulMod(difference, inverse, p)));
+            }
+            
+            modulus *= BigInteger(static_cast<long long>(p));
+            covered += std::log2(static_cast<long double>(p));
+            
+            // Keep the representative in (-modulus / 2, modulus / 2]
+            const BigInteger doubled = value + value;
+            if (modulus < doubled) 
+            {
+                value -= modulus;
+            }
+        }
+        
+        if (earlyTermination && stable >= kStableRequired) 
+        {
+            break;
+        }
+    }
+    
+    return value;
+}
+
+template <typename T>
+BigInteger DeterminantCalculator::calculateModularDeterminant(const Matrix<T>& matrix, size_t threads, bool earlyTermination) 
+{ 
+    return calculateModularDeterminant(matrix.view(), threads, earlyTermination); 
+}
+
+#define HWMX_INSTANTIATE(T) \
+    template BigInteger DeterminantCalculator::calculateModularDeterminant(MatrixView<const T>, size_t, bool); \
+    template BigInteger DeterminantCalculator::calculateModularDeterminant(const Matrix<T>&, size_t, bool);
+HWMX_FOR_EACH_SCALAR(HWMX_INSTANTIATE)
+#undef HWMX_INSTANTIATE
+
+} // namespace LinearAlgebra
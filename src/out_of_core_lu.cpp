@@ -0,0 +1,121 @@
+#include "determinant.h"
+#include "file_matrix.h"
+#include "tile_column_lu.h"
+#include "engines.h"
+#include <future>
+
+namespace LinearAlgebra 
+{
+
+namespace 
+{
+
+// Left-looking LU over a tile store. Tile column k is brought in, updated
+// with every finished panel j < k in turn (TileColumnLu::applyPanel) and
+// then factored and written back, so only two tile columns are worked on
+// at once however large the matrix is.
+//
+// Every buffer is doubled: panel j + 1 is read while panel j is applied,
+// column k + 1 is read and column k - 1 written while column k is worked
+// on, so disk traffic runs behind the arithmetic. The stored L columns are
+// never touched by later swaps; column k is updated with panel j before
+// any later panel's swaps reach it, which is the order L(:, j) is kept in.
+template <typename T>
+class OutOfCoreLu 
+{
+public:
+    OutOfCoreLu(FileMatrix<T>& matrix, size_t threads)
+        : matrix(matrix), nt(matrix.getTileCount()), steps(matrix.getSize(), matrix.getTileSize(), threads) 
+    {
+        const size_t b = matrix.getTileSize();
+        const AllocationPolicy scratch{ false, &BufferPool::shared() };
+        for (int t = 0; t < 2; ++t) 
+        {
+            columns[t] = allocateAligned<T>(nt * b * b, scratch);
+            panels[t] = allocateAligned<T>(nt * b * b, scratch);
+        }
+    }
+    
+    PivotProduct<T> run() 
+    {
+        PivotProduct<T> product;
+        if (nt == 0) return product;
+        
+        std::future<void> nextColumn = readAsync(columns[0].get(), 0, 0);
+        std::future<void> pendingWrite;
+        
+        for (size_t k = 0; k < nt; ++k) 
+        {
+            T* column = columns[k % 2].get();
+            nextColumn.get();
+            
+            // The other column buffer is free once column k - 1 is on disk
+            if (pendingWrite.valid()) pendingWrite.get();
+            if (k + 1 < nt) 
+            {
+                nextColumn = readAsync(columns[(k + 1) % 2].get(), k + 1, 0);
+            }
+            
+            std::future<void> nextPanel;
+            if (k > 0) nextPanel = readAsync(panels[0].get(), 0, 0);
+            
+            for (size_t j = 0; j < k; ++j) 
+            {
+                nextPanel.get();
+                if (j + 1 < k) 
+                {
+                    nextPanel = readAsync(panels[(j + 1) % 2].get(), j + 1, j + 1);
+                }
+                steps.applyPanel(column, panels[j % 2].get(), j, k);
+            }
+            
+            if (!steps.factorColumn(column, k, product)) 
+            {
+                product.markSingular();
+                return product;
+            }
+            
+            pendingWrite = std::async(std::launch::async, [this, column, k] { matrix.writeTiles(k, 0, column); });
+        }
+        
+        pendingWrite.get();
+        return product;
+    }
+    
+private:
+    std::future<void> readAsync(T* buffer, size_t column, size_t firstTile) 
+    {
+        return std::async(std::launch::async, [this, buffer, column, firstTile] 
+        {
+            matrix.readTiles(column, firstTile, buffer);
+        });
+    }
+    
+    FileMatrix<T>& matrix;
+    const size_t nt;
+    TileColumnLu<T> steps;
+    AlignedArray<T> columns[2];
+    AlignedArray<T> panels[2];
+};
+
+} // namespace
+
+template <typename T>
+T DeterminantCalculator::calculateOutOfCoreDeterminant(FileMatrix<T>& matrix, size_t threads) 
+{ 
+    return OutOfCoreLu<T>(matrix, threads).run().value(); 
+}
+
+template <typename T>
+DeterminantCalculator::LogDeterminant DeterminantCalculator::logOutOfCoreDeterminant(FileMatrix<T>& matrix, size_t threads) 
+{ 
+    return OutOfCoreLu<T>(matrix, threads).run().logValue(); 
+}
+
+#define HWMX_INSTANTIATE(T) \
+    template T DeterminantCalculator::calculateOutOfCoreDeterminant(FileMatrix<T>&, size_t); \
+    template DeterminantCalculator::LogDeterminant DeterminantCalculator::logOutOfCoreDeterminant(FileMatrix<T>&, size_t);
+HWMX_FOR_EACH_SCALAR(HWMX_INSTANTIATE)
+#undef HWMX_INSTANTIATE
+
+} // namespace LinearAlgebra
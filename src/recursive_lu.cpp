@@ -0,0 +1,186 @@
+#include "determinant.h"
+#include "lu_kernels.h"
+#include "engines.h"
+#include "scalar_traits.h"
+#include <algorithm>
+#include <cmath>
+
+namespace LinearAlgebra 
+{
+
+namespace 
+{
+
+// Recursion stops at these sizes only to amortize call overhead; none of
+// them is tied to a cache size.
+constexpr size_t kLeafColumns = 8;
+constexpr size_t kLeafSolve = 16;
+constexpr size_t kLeafProduct = 32;
+
+// C[m x n] -= A[m x k] * B[k x n], halving the largest dimension until the
+// block fits the base kernel; every cache level sees blocks of its own size
+// somewhere along the way.
+template <typename T>
+void multiplySubtract(T* c, const T* a, const T* b, size_t ld,
+                      size_t m, size_t n, size_t k) 
+{
+    if (m == 0 || n == 0 || k == 0) return;
+    
+    if (m <= kLeafProduct && n <= kLeafProduct && k <= kLeafProduct) 
+    {
+        T packed[kLeafProduct * kLeafProduct];
+        LuKernels::packTransposed(b, ld, k, n, packed);
+        LuKernels::multiplySubtract(c, ld, a, ld, packed, m, n, k);
+        return;
+    }
+    
+    if (m >= n && m >= k) 
+    {
+        const size_t m1 = m / 2;
+        multiplySubtract(c, a, b, ld, m1, n, k);
+        multiplySubtract(c + m1 * ld, a + m1 * ld, b, ld, m - m1, n, k);
+    }
+    else if (n >= k) 
+    {
+        const size_t n1 = n / 2;
+        multiplySubtract(c, a, b, ld, m, n1, k);
+        multiplySubtract(c + n1, a, b + n1, ld, m, n - n1, k);
+    }
+    else 
+    {
+        const size_t k1 = k / 2;
+        multiplySubtract(c, a, b, ld, m, n, k1);
+        multiplySubtract(c, a + k1, b + k1 * ld, ld, m, n, k - k1);
+    }
+}
+
+// B[w x n] = L^-1 B with L the unit lower triangle of a w x w block
+template <typename T>
+void solveUnitLower(const T* l, T* b, size_t ld, size_t w, size_t n) 
+{
+    if (w == 0 || n == 0) return;
+    
+    if (w <= kLeafSolve) 
+    {
+        LuKernels::solveUnitLower(l, ld, b, ld, w, n);
+        return;
+    }
+    
+    if (n > w) 
+    {
+        const size_t n1 = n / 2;
+        solveUnitLower(l, b, ld, w, n1);
+        solveUnitLower(l, b + n1, ld, w, n - n1);
+        return;
+    }
+    
+    const size_t w1 = w / 2;
+    solveUnitLower(l, b, ld, w1, n);
+    multiplySubtract(b + w1 * ld, l + w1 * ld, b, ld, w - w1, n, w1);
+    solveUnitLower(l + w1 * ld + w1, b + w1 * ld, ld, w - w1, n);
+}
+
+// Factor columns [c0, c0 + w) of rows [c0, n) by splitting the columns in
+// half: factor the left half, solve for its U12, update the right half and
+// recurse into it. Row swaps move whole rows, so both halves and the
+// columns outside the range always see the same row order.
+template <typename T>
+bool factorColumns(MatrixView<T> matrix, size_t c0, size_t w, PivotProduct<T>& product) 
+{
+    const size_t n = matrix.getSize();
+    T* a = matrix.getData();
+    const size_t lda = matrix.getStride();
+    
+    if (w <= kLeafColumns) 
+    {
+        const size_t c_end = c0 + w;
+        
+        for (size_t k = c0; k < c_end; ++k) 
+        {
+            size_t pivot_row = k;
+            T max_val = ScalarTraits<T>::abs(a[k * lda + k]);
+            
+            for (size_t i = k + 1; i < n; ++i) 
+            {
+                T val = ScalarTraits<T>::abs(a[i * lda + k]);
+                if (val > max_val) 
+                {
+                    max_val = val;
+                    pivot_row = i;
+                }
+            }
+            
+            if (pivot_row != k) 
+            {
+                matrix.swapRows(k, pivot_row);
+                product.negate();
+            }
+            
+            const T* row_k = a + k * lda;
+            T pivot_val = row_k[k];
+            
+            if (ScalarTraits<T>::abs(pivot_val) < T(1e-15L)) 
+            {
+                return false;
+            }
+            
+            product.multiply(pivot_val);
+            
+            for (size_t i = k + 1; i < n; ++i) 
+            {
+                T* row_i = a + i * lda;
+                T factor = row_i[k] / pivot_val;
+                row_i[k] = factor;
+                
+                for (size_t j = k + 1; j < c_end; ++j) 
+                {
+                    row_i[j] -= factor * row_k[j];
+                }
+            }
+        }
+        return true;
+    }
+    
+    const size_t w1 = w / 2;
+    const size_t c1 = c0 + w1;
+    
+    if (!factorColumns(matrix, c0, w1, product)) 
+    {
+        return false;
+    }
+    
+    solveUnitLower(a + c0 * lda + c0, a + c0 * lda + c1, lda, w1, w - w1);
+    multiplySubtract(a + c1 * lda + c1, a + c1 * lda + c0, a + c0 * lda + c1, lda, n - c1, w - w1, w1);
+    
+    return factorColumns(matrix, c1, w - w1, product);
+}
+
+} // namespace
+
+template <typename T>
+PivotProduct<T> Engines::recursive(MatrixView<T> matrix) 
+{
+    const size_t n = matrix.getSize();
+    PivotProduct<T> product;
+    
+    if (n == 0) return product;
+    if (n == 1) 
+    {
+        product.multiply(matrix(0, 0));
+        return product;
+    }
+    
+    if (!factorColumns(matrix, 0, n, product)) 
+    {
+        product.markSingular();
+    }
+    
+    return product;
+}
+
+#define HWMX_INSTANTIATE(T) \
+    template PivotProduct<T> Engines::recursive(MatrixView<T>);
+HWMX_FOR_EACH_SCALAR(HWMX_INSTANTIATE)
+#undef HWMX_INSTANTIATE
+
+} // namespace LinearAlgebra
@@ -0,0 +1,104 @@
+// Per-scalar-type helpers for the templated matrix and engines. float,
+// double and long double go straight to <cmath>; __float128 has no standard
+// library support without libquadmath, so its few needs are built from
+// long double, which shares its 15-bit exponent range.
+
+#ifndef SCALAR_TRAITS_H
+#define SCALAR_TRAITS_H
+
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+// Expands X(T) once per supported element type; used for the explicit
+// instantiations at the bottom of every templated translation unit
+#ifdef __SIZEOF_FLOAT128__
+#define HWMX_FOR_EACH_SCALAR(X) X(float) X(double) X(long double) X(__float128)
+#else
+#define HWMX_FOR_EACH_SCALAR(X) X(float) X(double) X(long double)
+#endif
+
+namespace LinearAlgebra 
+{
+
+template <typename T>
+struct ScalarTraits 
+{
+    // Type the text readers parse into before converting to T
+    using Parsed = T;
+    // Precision the adaptive engine escalates to when double is not enough
+    using Escalated = long double;
+    
+    static T abs(T value) { return std::fabs(value); }
+    static T frexp(T value, int* exponent) { return std::frexp(value, exponent); }
+    static T ldexp(T value, int exponent) { return std::ldexp(value, exponent); }
+};
+
+#ifdef __SIZEOF_FLOAT128__
+template <>
+struct ScalarTraits<__float128> 
+{
+    // Streams cannot read __float128; input gets long double's 64-bit mantissa
+    using Parsed = long double;
+    using Escalated = __float128;
+    
+    static __float128 abs(__float128 value) { return value < 0 ? -value : value; }
+    
+    static __float128 frexp(__float128 value, int* exponent) 
+    {
+        *exponent = 0;
+        if (value == 0 || value != value) return value;
+        
+        std::frexp(static_cast<long double>(value), exponent);
+        __float128 mantissa = ldexp(value, -*exponent);
+        
+        // Rounding to 64 bits can carry into the next binade
+        if (abs(mantissa) >= 1) 
+        {
+            mantissa /= 2;
+            ++*exponent;
+        }
+        return mantissa;
+    }
+    
+    // Scaling by powers of two is exact, so it can go in chunks that stay
+    // inside long double's normal range
+    static __float128 ldexp(__float128 value, int exponent) 
+    {
+        constexpr int kStep = 8192;
+        while (exponent > kStep) 
+        {
+            value *= static_cast<__float128>(std::ldexp(1.0L, kStep));
+            exponent -= kStep;
+        }
+        while (exponent < -kStep) 
+        {
+            value *= static_cast<__float128>(std::ldexp(1.0L, -kStep));
+            exponent += kStep;
+        }
+        return value * static_cast<__float128>(std::ldexp(1.0L, exponent));
+    }
+};
+#endif
+
+// Element type recorded in the binary file formats. long double and
+// __float128 are both 16 bytes, so the size alone cannot tell them apart.
+template <typename T>
+constexpr uint32_t scalarTag() 
+{
+    if (std::is_same_v<T, float>) return 1;
+    if (std::is_same_v<T, double>) return 2;
+    if (std::is_same_v<T, long double>) return 3;
+    return 4;
+}
+
+// Integer-valued and inside the int64 range, where the exact engines are
+// cheap; the readers set Matrix::isIntegral from it
+inline bool isSmallInteger(long double value) 
+{ 
+    return std::isfinite(value) && std::trunc(value) == value && std::fabs(value) < 9223372036854775808.0L; 
+}
+
+} // namespace LinearAlgebra
+
+#endif // SCALAR_TRAITS_H
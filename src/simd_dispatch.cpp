@@ -0,0 +1,49 @@
+#include "simd_kernels.h"
+#include <cstdlib>
+#include <string>
+
+namespace LinearAlgebra 
+{
+
+namespace Simd 
+{
+
+extern const KernelTable scalarKernelTable;
+#ifdef HWMX_X86_KERNELS
+extern const KernelTable avx2KernelTable;
+extern const KernelTable avx512KernelTable;
+#endif
+
+namespace 
+{
+
+const KernelTable& selectKernels() 
+{
+#ifdef HWMX_X86_KERNELS
+    const char* env = std::getenv("HWMX_SIMD");
+    const std::string cap = env ? env : "";
+    
+    __builtin_cpu_init();
+    if (cap != "scalar" && cap != "avx2" && __builtin_cpu_supports("avx512f")) 
+    {
+        return avx512KernelTable;
+    }
+    if (cap != "scalar" && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) 
+    {
+        return avx2KernelTable;
+    }
+#endif
+    return scalarKernelTable;
+}
+
+} // namespace
+
+const KernelTable& kernels() 
+{
+    static const KernelTable& table = selectKernels();
+    return table;
+}
+
+} // namespace Simd
+
+} // namespace LinearAlgebra
@@ -0,0 +1,3 @@
+#define HWMX_KERNEL_TABLE avx2KernelTable
+#define HWMX_KERNEL_NAME "avx2"
+#include "simd_kernels_impl.h"
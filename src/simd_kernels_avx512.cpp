@@ -0,0 +1,3 @@
+#define HWMX_KERNEL_TABLE avx512KernelTable
+#define HWMX_KERNEL_NAME "avx512"
+#include "simd_kernels_impl.h"
@@ -0,0 +1,410 @@
+// Kernel bodies shared by simd_kernels_{scalar,avx2,avx512}.cpp. Each of those
+// translation units is compiled with its own -m flags and includes this file
+// once, after defining HWMX_KERNEL_TABLE (the exported table symbol) and
+// HWMX_KERNEL_NAME. Everything except the table has internal linkage so the
+// per-ISA copies never get merged by the linker.
+
+#include "simd_kernels.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace LinearAlgebra 
+{
+
+namespace Simd 
+{
+
+namespace 
+{
+
+#if defined(__AVX512F__)
+
+size_t findPivot(const double* x, size_t count) 
+{
+    if (count == 0) return 0;
+    
+    // The unmasked max and _mm512_reduce_max_pd pass _mm512_undefined_pd()
+    // as the merge source, which GCC 12 reports as maybe-uninitialized; the
+    // masked max with vmax as the source and a reduction through memory
+    // compute the same without it
+    __m512d vmax = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) 
+    {
+        vmax = _mm512_mask_max_pd(vmax, 0xFF, _mm512_abs_pd(_mm512_loadu_pd(x + i)), vmax);
+    }
+    if (i < count) 
+    {
+        const __mmask8 tail = static_cast<__mmask8>((1u << (count - i)) - 1);
+        vmax = _mm512_mask_max_pd(vmax, 0xFF, _mm512_abs_pd(_mm512_maskz_loadu_pd(tail, x + i)), vmax);
+    }
+    alignas(64) double lanes[8];
+    _mm512_store_pd(lanes, vmax);
+    const __m512d target = _mm512_set1_pd(*std::max_element(lanes, lanes + 8));
+    
+    // Second pass: first position holding the maximum, matching the scalar scan
+    for (i = 0; i < count; i += 8) 
+    {
+        const __mmask8 valid = count - i >= 8 ? 0xFF : static_cast<__mmask8>((1u << (count - i)) - 1);
+        const __m512d v = _mm512_abs_pd(_mm512_maskz_loadu_pd(valid, x + i));
+        const __mmask8 hit = _mm512_mask_cmp_pd_mask(valid, v, target, _CMP_EQ_OQ);
+        if (hit) 
+        {
+            return i + static_cast<size_t>(__builtin_ctz(hit));
+        }
+    }
+    return 0;
+}
+
+void axpy(double* y, const double* x, double alpha, size_t count) 
+{
+    const __m512d a = _mm512_set1_pd(alpha);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) 
+    {
+        _mm512_storeu_pd(y + i, _mm512_fnmadd_pd(a, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+    }
+    if (i < count) 
+    {
+        const __mmask8 tail = static_cast<__mmask8>((1u << (count - i)) - 1);
+        const __m512d r = _mm512_fnmadd_pd(a, _mm512_maskz_loadu_pd(tail, x + i), _mm512_maskz_loadu_pd(tail, y + i));
+        _mm512_mask_storeu_pd(y + i, tail, r);
+    }
+}
+
+void scale(double* x, double alpha, size_t count) 
+{
+    const __m512d a = _mm512_set1_pd(alpha);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) 
+    {
+        _mm512_storeu_pd(x + i, _mm512_mul_pd(a, _mm512_loadu_pd(x + i)));
+    }
+    if (i < count) 
+    {
+        const __mmask8 tail = static_cast<__mmask8>((1u << (count - i)) - 1);
+        _mm512_mask_storeu_pd(x + i, tail, _mm512_mul_pd(a, _mm512_maskz_loadu_pd(tail, x + i)));
+    }
+}
+
+// Lane helpers for the batched kernel
+using Lanes = __m512d;
+using LaneMask = __mmask8;
+constexpr size_t kBatchLanes = 8;
+
+inline Lanes laneSet(double value) { return _mm512_set1_pd(value); }
+inline Lanes laneLoad(const double* p) { return _mm512_loadu_pd(p); }
+inline void laneStore(double* p, Lanes v) { _mm512_storeu_pd(p, v); }
+inline Lanes laneAbs(Lanes v) { return _mm512_abs_pd(v); }
+inline LaneMask laneGreater(Lanes a, Lanes b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+inline LaneMask laneEqual(Lanes a, Lanes b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+inline Lanes laneSelect(LaneMask m, Lanes yes, Lanes no) { return _mm512_mask_blend_pd(m, no, yes); }
+inline Lanes laneSub(Lanes a, Lanes b) { return _mm512_sub_pd(a, b); }
+inline Lanes laneMul(Lanes a, Lanes b) { return _mm512_mul_pd(a, b); }
+inline Lanes laneDiv(Lanes a, Lanes b) { return _mm512_div_pd(a, b); }
+inline Lanes laneFnmadd(Lanes a, Lanes b, Lanes c) { return _mm512_fnmadd_pd(a, b, c); }
+
+#elif defined(__AVX2__)
+
+size_t findPivot(const double* x, size_t count) 
+{
+    const __m256d sign_mask = _mm256_set1_pd(-0.0);
+    __m256d vmax = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) 
+    {
+        vmax = _mm256_max_pd(_mm256_andnot_pd(sign_mask, _mm256_loadu_pd(x + i)), vmax);
+    }
+    
+    const __m128d half = _mm_max_pd(_mm256_castpd256_pd128(vmax), _mm256_extractf128_pd(vmax, 1));
+    double max_val = std::fmax(_mm_cvtsd_f64(half), _mm_cvtsd_f64(_mm_unpackhi_pd(half, half)));
+    for (size_t t = i; t < count; ++t) 
+    {
+        if (std::fabs(x[t]) > max_val) max_val = std::fabs(x[t]);
+    }
+    
+    // Second pass: first position holding the maximum, matching the scalar scan
+    const __m256d target = _mm256_set1_pd(max_val);
+    for (i = 0; i + 4 <= count; i += 4) 
+    {
+        const __m256d v = _mm256_andnot_pd(sign_mask, _mm256_loadu_pd(x + i));
+        const int hit = _mm256_movemask_pd(_mm256_cmp_pd(v, target, _CMP_EQ_OQ));
+        if (hit) 
+        {
+            return i + static_cast<size_t>(__builtin_ctz(hit));
+        }
+    }
+    for (; i < count; ++i) 
+    {
+        if (std::fabs(x[i]) == max_val) return i;
+    }
+    return 0;
+}
+
+void axpy(double* y, const double* x, double alpha, size_t count) 
+{
+    const __m256d a = _mm256_set1_pd(alpha);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) 
+    {
+        _mm256_storeu_pd(y + i, _mm256_fnmadd_pd(a, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+        _mm256_storeu_pd(y + i + 4, _mm256_fnmadd_pd(a, _mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4)));
+    }
+    for (; i + 4 <= count; i += 4) 
+    {
+        _mm256_storeu_pd(y + i, _mm256_fnmadd_pd(a, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+    }
+    for (; i < count; ++i) 
+    {
+        y[i] -= alpha * x[i];
+    }
+}
+
+void scale(double* x, double alpha, size_t count) 
+{
+    const __m256d a = _mm256_set1_pd(alpha);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) 
+    {
+        _mm256_storeu_pd(x + i, _mm256_mul_pd(a, _mm256_loadu_pd(x + i)));
+    }
+    for (; i < count; ++i) 
+    {
+        x[i] *= alpha;
+    }
+}
+
+// Lane helpers for the batched kernel; compares yield all-ones lane masks
+using Lanes = __m256d;
+using LaneMask = __m256d;
+constexpr size_t kBatchLanes = 4;
+
+inline Lanes laneSet(double value) { return _mm256_set1_pd(value); }
+inline Lanes laneLoad(const double* p) { return _mm256_loadu_pd(p); }
+inline void laneStore(double* p, Lanes v) { _mm256_storeu_pd(p, v); }
+inline Lanes laneAbs(Lanes v) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), v); }
+inline LaneMask laneGreater(Lanes a, Lanes b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+inline LaneMask laneEqual(Lanes a, Lanes b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+inline Lanes laneSelect(LaneMask m, Lanes yes, Lanes no) { return _mm256_blendv_pd(no, yes, m); }
+inline Lanes laneSub(Lanes a, Lanes b) { return _mm256_sub_pd(a, b); }
+inline Lanes laneMul(Lanes a, Lanes b) { return _mm256_mul_pd(a, b); }
+inline Lanes laneDiv(Lanes a, Lanes b) { return _mm256_div_pd(a, b); }
+inline Lanes laneFnmadd(Lanes a, Lanes b, Lanes c) { return _mm256_fnmadd_pd(a, b, c); }
+
+#else
+
+size_t findPivot(const double* x, size_t count) 
+{
+    size_t pivot = 0;
+    double max_val = count ? std::fabs(x[0]) : 0.0;
+    for (size_t i = 1; i < count; ++i) 
+    {
+        const double val = std::fabs(x[i]);
+        if (val > max_val) 
+        {
+            max_val = val;
+            pivot = i;
+        }
+    }
+    return pivot;
+}
+
+void axpy(double* y, const double* x, double alpha, size_t count) 
+{
+    for (size_t i = 0; i < count; ++i) 
+    {
+        y[i] -= alpha * x[i];
+    }
+}
+
+void scale(double* x, double alpha, size_t count) 
+{
+    for (size_t i = 0; i < count; ++i) 
+    {
+        x[i] *= alpha;
+    }
+}
+
+
+// Lane helpers for the batched kernel: a single lane, so it is a plain
+// per-matrix elimination with the same pivoting rule
+using Lanes = double;
+using LaneMask = bool;
+constexpr size_t kBatchLanes = 1;
+
+inline Lanes laneSet(double value) { return value; }
+inline Lanes laneLoad(const double* p) { return *p; }
+inline void laneStore(double* p, Lanes v) { *p = v; }
+inline Lanes laneAbs(Lanes v) { return std::fabs(v); }
+inline LaneMask laneGreater(Lanes a, Lanes b) { return a > b; }
+inline LaneMask laneEqual(Lanes a, Lanes b) { return a == b; }
+inline Lanes laneSelect(LaneMask m, Lanes yes, Lanes no) { return m ? yes : no; }
+inline Lanes laneSub(Lanes a, Lanes b) { return a - b; }
+inline Lanes laneMul(Lanes a, Lanes b) { return a * b; }
+inline Lanes laneDiv(Lanes a, Lanes b) { return a / b; }
+inline Lanes laneFnmadd(Lanes a, Lanes b, Lanes c) { return c - a * b; }
+
+#endif
+
+// Batched small determinants: one matrix per lane of a Lanes register. The
+// lane helpers defined next to each kernel set above are all the shared body
+// needs; per-lane pivot choice and row swaps become compares and blends.
+// The order is a template parameter so every loop has a fixed trip count:
+// the compiler unrolls them and small matrices stay entirely in registers.
+template <size_t n>
+void batchBlock(const double* matrices, size_t stride, size_t lanes, double* out) 
+{
+    Lanes a[n * n];
+    
+    // Padding lanes of a partial block are zero; they come out singular
+    for (size_t e = 0; e < n * n; ++e) 
+    {
+        const double* source = matrices + e * stride;
+        if (lanes == kBatchLanes) 
+        {
+            a[e] = laneLoad(source);
+        }
+        else 
+        {
+            alignas(64) double padded[kBatchLanes] = {};
+            std::copy(source, source + lanes, padded);
+            a[e] = laneLoad(padded);
+        }
+    }
+    
+    const Lanes zero = laneSet(0.0);
+    const Lanes threshold = laneSet(1e-15);   // same singularity test as the SIMD engine
+    Lanes det = laneSet(1.0);
+    
+    for (size_t k = 0; k < n; ++k) 
+    {
+        // Pivot row per lane, kept as doubles so it blends like the data
+        const Lanes diagonal = laneSet(static_cast<double>(k));
+        Lanes best = laneAbs(a[k * n + k]);
+        Lanes row = diagonal;
+        for (size_t i = k + 1; i < n; ++i) 
+        {
+            const Lanes value = laneAbs(a[i * n + k]);
+            const LaneMask better = laneGreater(value, best);
+            best = laneSelect(better, value, best);
+            row = laneSelect(better, laneSet(static_cast<double>(i)), row);
+        }
+        
+        for (size_t i = k + 1; i < n; ++i) 
+        {
+            const LaneMask take = laneEqual(row, laneSet(static_cast<double>(i)));
+            for (size_t j = k; j < n; ++j) 
+            {
+                const Lanes top = a[k * n + j];
+                const Lanes other = a[i * n + j];
+                a[k * n + j] = laneSelect(take, other, top);
+                a[i * n + j] = laneSelect(take, top, other);
+            }
+        }
+        
+        // A singular lane keeps going with a zero multiplier, so it cannot
+        // produce NaNs; its determinant is already pinned to zero
+        const Lanes pivot = a[k * n + k];
+        const LaneMask singular = laneGreater(threshold, laneAbs(pivot));
+        det = laneSelect(laneEqual(row, diagonal), det, laneSub(zero, det));
+        det = laneSelect(singular, zero, laneMul(det, pivot));
+        const Lanes inverse = laneSelect(singular, zero, laneDiv(laneSet(1.0), pivot));
+        
+        for (size_t i = k + 1; i < n; ++i) 
+        {
+            const Lanes factor = laneMul(a[i * n + k], inverse);
+            for (size_t j = k + 1; j < n; ++j) 
+            {
+                a[i * n + j] = laneFnmadd(factor, a[k * n + j], a[i * n + j]);
+            }
+        }
+    }
+    
+    if (lanes == kBatchLanes) 
+    {
+        laneStore(out, det);
+    }
+    else 
+    {
+        alignas(64) double result[kBatchLanes];
+        laneStore(result, det);
+        std::copy(result, result + lanes, out);
+    }
+}
+
+template <size_t n>
+void batchRun(const double* matrices, size_t stride, size_t count, double* out) 
+{
+    for (size_t b = 0; b < count; b += kBatchLanes) 
+    {
+        batchBlock<n>(matrices + b, stride, std::min(kBatchLanes, count - b), out + b);
+    }
+}
+
+template <size_t... orders>
+constexpr auto batchRunners(std::index_sequence<orders...>) 
+{
+    using Runner = void (*)(const double*, size_t, size_t, double*);
+    return std::array<Runner, sizeof...(orders)>{ batchRun<orders + 1>... };
+}
+
+void batchDeterminant(const double* matrices, size_t n, size_t stride, size_t count, double* out) 
+{
+    static constexpr auto runners = batchRunners(std::make_index_sequence<kBatchMaxOrder>());
+    runners[n - 1](matrices, stride, count, out);
+}
+
+// The AVX-512 table uses the AVX2 form too: byte compares on zmm registers
+// need AVX512BW, which the avx512 translation unit is not built for
+#if defined(__AVX2__)
+
+size_t countByte(const char* data, size_t count, char byte) 
+{
+    const __m256i target = _mm256_set1_epi8(byte);
+    size_t total = 0;
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) 
+    {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const unsigned hits = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target)));
+        total += static_cast<size_t>(__builtin_popcount(hits));
+    }
+    for (; i < count; ++i) 
+    {
+        total += data[i] == byte;
+    }
+    return total;
+}
+
+#else
+
+size_t countByte(const char* data, size_t count, char byte) 
+{
+    return static_cast<size_t>(std::count(data, data + count, byte));
+}
+
+#endif
+
+} // namespace
+
+extern const KernelTable HWMX_KERNEL_TABLE;
+
+const KernelTable HWMX_KERNEL_TABLE = 
+{
+    HWMX_KERNEL_NAME,
+    findPivot,
+    axpy,
+    scale,
+    batchDeterminant,
+    countByte
+};
+
+} // namespace Simd
+
+} // namespace LinearAlgebra
@@ -0,0 +1,3 @@
+#define HWMX_KERNEL_TABLE scalarKernelTable
+#define HWMX_KERNEL_NAME "scalar"
+#include "simd_kernels_impl.h"
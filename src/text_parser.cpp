@@ -0,0 +1,180 @@
+#include "text_parser.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace LinearAlgebra 
+{
+
+namespace TextParser 
+{
+
+MappedFile::MappedFile(const std::string& path) 
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) 
+    {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    
+    struct stat status{};
+    if (::fstat(fd, &status) != 0) 
+    {
+        ::close(fd);
+        throw std::runtime_error("Cannot open file: " + path + ": " + std::strerror(errno));
+    }
+    
+    length = static_cast<size_t>(status.st_size);
+    if (length > 0) 
+    {
+        void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) 
+        {
+            ::close(fd);
+            throw std::runtime_error("Cannot map file: " + path + ": " + std::strerror(errno));
+        }
+        // One front-to-back scan: let the kernel read ahead aggressively
+        ::madvise(mapped, length, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapped);
+    }
+    // The mapping keeps the file contents reachable on its own
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() 
+{
+    if (data) 
+    {
+        ::munmap(const_cast<char*>(data), length);
+    }
+}
+
+namespace 
+{
+
+constexpr size_t kReadChunk = size_t(1) << 20;
+
+} // namespace
+
+LineSource::LineSource(const std::string& path) 
+{
+    if (path == "-") 
+    {
+        fd = STDIN_FILENO;
+    }
+    else 
+    {
+        struct stat status{};
+        if (::stat(path.c_str(), &status) == 0 && S_ISREG(status.st_mode)) 
+        {
+            mapped = std::make_unique<MappedFile>(path);
+            cursor = mapped->begin();
+            return;
+        }
+        
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) 
+        {
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+        ownsFd = true;
+    }
+    buffer.resize(kReadChunk);
+}
+
+LineSource::~LineSource() 
+{
+    if (ownsFd) 
+    {
+        ::close(fd);
+    }
+}
+
+bool LineSource::nextLine(const char*& begin, const char*& end) 
+{
+    if (mapped) 
+    {
+        if (cursor == mapped->end()) return false;
+        begin = cursor;
+        end = std::find(cursor, mapped->end(), '\n');
+        cursor = end == mapped->end() ? end : end + 1;
+        return true;
+    }
+    
+    size_t scanned = 0;   // bytes past start already known to hold no '\n'
+    for (;;) 
+    {
+        const char* newline = std::find(buffer.data() + start + scanned, buffer.data() + filled, '\n');
+        if (newline != buffer.data() + filled) 
+        {
+            begin = buffer.data() + start;
+            end = newline;
+            start = static_cast<size_t>(newline - buffer.data()) + 1;
+            return true;
+        }
+        scanned = filled - start;
+        
+        if (!fill()) 
+        {
+            // A last line without its '\n'
+            if (start == filled) return false;
+            begin = buffer.data() + start;
+            end = buffer.data() + filled;
+            start = filled;
+            return true;
+        }
+    }
+}
+
+bool LineSource::unread(const char*& begin, const char*& end) const 
+{
+    if (!mapped) return false;
+    begin = cursor;
+    end = mapped->end();
+    return true;
+}
+
+// Reads the next chunk behind the unread bytes, first moving those to the
+// front and growing the buffer only when a single line fills it
+bool LineSource::fill() 
+{
+    if (exhausted) return false;
+    
+    if (start > 0) 
+    {
+        std::copy(buffer.begin() + start, buffer.begin() + filled, buffer.begin());
+        filled -= start;
+        start = 0;
+    }
+    if (filled == buffer.size()) 
+    {
+        buffer.resize(buffer.size() * 2);
+    }
+    
+    for (;;) 
+    {
+        const ssize_t done = ::read(fd, buffer.data() + filled, buffer.size() - filled);
+        if (done < 0 && errno == EINTR) continue;
+        if (done < 0) 
+        {
+            throw std::runtime_error(std::string("Read failed: ") + std::strerror(errno));
+        }
+        if (done == 0) 
+        {
+            exhausted = true;
+            return false;
+        }
+        filled += static_cast<size_t>(done);
+        return true;
+    }
+}
+
+} // namespace TextParser
+
+} // namespace LinearAlgebra
@@ -0,0 +1,236 @@
+// Text matrix scanning shared by the readers: regular files are
+// memory-mapped, pipes and other unseekable sources are read through one
+// reused buffer, and numbers are converted with std::from_chars straight
+// from there, so no line or token is ever copied and the C locale is never
+// consulted. The format is whitespace-separated decimal numbers, one matrix
+// row per line; the order is the number of values on the first line.
+
+#ifndef TEXT_PARSER_H
+#define TEXT_PARSER_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace LinearAlgebra 
+{
+
+namespace TextParser 
+{
+
+// Read-only mapping of a whole file; an empty file is an empty range
+class MappedFile 
+{
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    const char* begin() const { return data; }
+    const char* end() const { return data + length; }
+    size_t size() const { return length; }
+    
+private:
+    const char* data = nullptr;
+    size_t length = 0;
+};
+
+// The lines of a file, front to back, each exactly once. Regular files are
+// mapped; anything else (a pipe, a FIFO, "-" for standard input) is read
+// in chunks into a buffer that grows only to the longest line, so a
+// generator can stream a matrix in without it ever touching the disk.
+class LineSource 
+{
+public:
+    explicit LineSource(const std::string& path);
+    ~LineSource();
+    
+    LineSource(const LineSource&) = delete;
+    LineSource& operator=(const LineSource&) = delete;
+    
+    // [begin, end) of the next line without its '\n'; false past the last
+    // line. The range stays valid until the next call.
+    bool nextLine(const char*& begin, const char*& end);
+    // [begin, end) of everything not yet returned, for callers that split
+    // the rest of a mapped file up themselves; false for a streamed source
+    bool unread(const char*& begin, const char*& end) const;
+    
+private:
+    bool fill();
+    
+    std::unique_ptr<MappedFile> mapped;
+    const char* cursor = nullptr;   // next unread byte of the mapping
+    
+    int fd = -1;
+    bool ownsFd = false;
+    bool exhausted = false;
+    std::vector<char> buffer;
+    size_t start = 0;    // first unread byte of buffer
+    size_t filled = 0;   // end of the bytes read into buffer
+};
+
+// Blanks within a line; '\n' ends the line and is not skipped
+inline bool isBlank(char c) 
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline const char* skipBlanks(const char* cursor, const char* end) 
+{
+    while (cursor != end && isBlank(*cursor)) ++cursor;
+    return cursor;
+}
+
+// Just past the '\n' that ends the current line, or end
+inline const char* nextLine(const char* cursor, const char* end) 
+{
+    while (cursor != end && *cursor != '\n') ++cursor;
+    return cursor == end ? end : cursor + 1;
+}
+
+namespace Detail 
+{
+
+inline bool isDigit(char c) 
+{
+    return c >= '0' && c <= '9';
+}
+
+// Largest e for which 10^e is exact in V: 5^e must fit the mantissa
+template <typename V>
+constexpr int exactPowerLimit() 
+{
+    constexpr int kBits = std::numeric_limits<V>::digits;
+    const uint64_t top = kBits >= 64 ? UINT64_MAX : (uint64_t(1) << kBits) - 1;
+    int limit = 0;
+    for (uint64_t power = 1; power <= top / 5; power *= 5) 
+    {
+        ++limit;
+    }
+    return limit;
+}
+
+template <typename V>
+struct PowersOfTen 
+{
+    static constexpr int kLimit = exactPowerLimit<V>();
+    V values[kLimit + 1] = {};
+    
+    constexpr PowersOfTen() 
+    {
+        values[0] = 1;
+        for (int e = 1; e <= kLimit; ++e) values[e] = values[e - 1] * 10;
+    }
+};
+
+// Clinger's fast path: a decimal with no more significant digits than an
+// integer mantissa of V holds, scaled by an exactly representable power of
+// ten, is converted by one correctly rounded multiplication or division.
+// libstdc++ hands long double to strtold, an order of magnitude slower,
+// and typical matrix entries (up to 19 digits, modest exponents) never
+// need it. False, with nothing consumed, when the input is outside the
+// fast path.
+template <typename V>
+inline bool parseExact(const char* start, const char* end, V& value, const char*& next) 
+{
+    static constexpr PowersOfTen<V> kPowers;
+    constexpr int kMaxDigits = 19;   // 10^19 - 1 < 2^64
+    
+    const char* p = start;
+    const bool negative = p != end && *p == '-';
+    if (negative) ++p;
+    
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+    
+    for (; p != end && isDigit(*p); ++p) 
+    {
+        any = true;
+        if (mantissa == 0 && *p == '0') continue;
+        if (++digits > kMaxDigits) return false;
+        mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+    }
+    if (p != end && *p == '.') 
+    {
+        for (++p; p != end && isDigit(*p); ++p) 
+        {
+            any = true;
+            --exponent;
+            if (mantissa == 0 && *p == '0') continue;
+            if (++digits > kMaxDigits) return false;
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+        }
+    }
+    if (!any) return false;
+    
+    // An 'e' without digits after it is not part of the number
+    if (p != end && (*p == 'e' || *p == 'E')) 
+    {
+        const char* q = p + 1;
+        const bool negativeExponent = q != end && *q == '-';
+        if (q != end && (*q == '-' || *q == '+')) ++q;
+        if (q != end && isDigit(*q)) 
+        {
+            int scale = 0;
+            for (; q != end && isDigit(*q); ++q) 
+            {
+                if (scale < 100000) scale = scale * 10 + (*q - '0');
+            }
+            exponent += negativeExponent ? -scale : scale;
+            p = q;
+        }
+    }
+    
+    if (mantissa == 0) 
+    {
+        value = negative ? -V(0) : V(0);
+    }
+    else 
+    {
+        if (exponent < -kPowers.kLimit || exponent > kPowers.kLimit) return false;
+        value = static_cast<V>(mantissa);
+        value = exponent < 0 ? value / kPowers.values[-exponent] : value * kPowers.values[exponent];
+        if (negative) value = -value;
+    }
+    next = p;
+    return true;
+}
+
+} // namespace Detail
+
+// Next number of the current line into value, moving cursor past it; false
+// at the end of the line, at anything that is not a number and at numbers
+// outside V's range, which the stream readers reject as well. A leading '+'
+// is accepted, as operator>> accepts it.
+template <typename V>
+inline bool parseValue(const char*& cursor, const char* end, V& value) 
+{
+    const char* start = skipBlanks(cursor, end);
+    if (start != end && *start == '+' && start + 1 != end && *(start + 1) != '-') ++start;
+    
+    if constexpr (std::is_same_v<V, long double> && std::numeric_limits<long double>::digits <= 64) 
+    {
+        if (Detail::parseExact(start, end, value, cursor)) return true;
+    }
+    
+    const std::from_chars_result result = std::from_chars(start, end, value);
+    if (result.ec != std::errc()) return false;
+    cursor = result.ptr;
+    return true;
+}
+
+} // namespace TextParser
+
+} // namespace LinearAlgebra
+
+#endif // TEXT_PARSER_H
@@ -0,0 +1,114 @@
+#include "thread_pool.h"
+
+namespace LinearAlgebra 
+{
+
+ThreadPool::ThreadPool(size_t threads) 
+{
+    for (size_t worker = 1; worker < threads; ++worker) 
+    {
+        workers.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool() 
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) 
+    {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::getThreadCount() const 
+{
+    return workers.size() + 1;
+}
+
+void ThreadPool::parallelFor(size_t chunks, const ChunkBody& body) 
+{
+    if (workers.empty() || chunks <= 1) 
+    {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) 
+        {
+            body(chunk, 0);
+        }
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &body;
+        jobChunks = chunks;
+        nextChunk.store(0, std::memory_order_relaxed);
+        busy = workers.size();
+        failure = nullptr;
+        ++generation;
+    }
+    wake.notify_all();
+    
+    runChunks(0);
+    
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return busy == 0; });
+        job = nullptr;
+        error = failure;
+    }
+    
+    if (error) 
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::workerLoop(size_t worker) 
+{
+    size_t seen = 0;
+    
+    for (;;) 
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        
+        runChunks(worker);
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy == 0) 
+        {
+            done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::runChunks(size_t worker) 
+{
+    for (;;) 
+    {
+        const size_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= jobChunks) return;
+        
+        try 
+        {
+            (*job)(chunk, worker);
+        } 
+        catch (...) 
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!failure) failure = std::current_exception();
+            // Drain the remaining chunks so the loop finishes promptly
+            nextChunk.store(jobChunks, std::memory_order_relaxed);
+        }
+    }
+}
+
+} // namespace LinearAlgebra
@@ -0,0 +1,146 @@
+// Left-looking LU steps on tile-major storage, shared by the in-memory
+// tile-major engine and the out-of-core engine. A tile column is the
+// stack of its b x b row-major tiles, i.e. a (nt * b) x b row-major block
+// with leading dimension b; rows past n are zero padding.
+
+#ifndef TILE_COLUMN_LU_H
+#define TILE_COLUMN_LU_H
+
+#include "aligned_buffer.h"
+#include "thread_pool.h"
+#include "lu_kernels.h"
+#include "engines.h"
+#include "scalar_traits.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace LinearAlgebra 
+{
+
+template <typename T>
+class TileColumnLu 
+{
+public:
+    TileColumnLu(size_t n, size_t tileSize, size_t threads)
+        : n(n), b(tileSize), nt((n + tileSize - 1) / tileSize), pivots(n),
+          pool(threads > 1 ? std::make_unique<ThreadPool>(threads) : nullptr),
+          packed(allocateAligned<T>(tileSize * tileSize, AllocationPolicy{ false, &BufferPool::shared() })) 
+    {
+    }
+    
+    // Bring tile column k up to date with panel j:
+    //   replay panel j's row swaps on column k
+    //   U(j, k) = L(j, j)^-1 A(j, k)
+    //   A(i, k) -= L(i, j) U(j, k)        for tile rows i > j
+    // `panel` points at tile (j, j) of column j, `column` at tile (0, k)
+    void applyPanel(T* column, const T* panel, size_t j, size_t k) 
+    {
+        const size_t j0 = j * b;
+        const size_t jb = extent(j);
+        const size_t cols = extent(k);
+        
+        for (size_t r = j0; r < j0 + jb; ++r) 
+        {
+            if (pivots[r] != r) 
+            {
+                std::swap_ranges(column + r * b, column + r * b + b, column + pivots[r] * b);
+            }
+        }
+        
+        T* u = column + j0 * b;
+        LuKernels::solveUnitLower(panel, b, u, b, jb, cols);
+        
+        const size_t below = nt - j - 1;
+        if (below == 0) return;
+        
+        LuKernels::packTransposed(u, b, jb, cols, packed.get());
+        auto updateTile = [&](size_t t, size_t) 
+        {
+            const size_t ti = j + 1 + t;
+            LuKernels::multiplySubtract(column + ti * b * b, b, panel + (ti - j) * b * b, b, packed.get(),
+                                        extent(ti), cols, jb);
+        };
+        
+        if (pool) 
+        {
+            pool->parallelFor(below, updateTile);
+        }
+        else 
+        {
+            for (size_t t = 0; t < below; ++t) updateTile(t, 0);
+        }
+    }
+    
+    // Partial pivoting over rows k0..n-1 of the updated tile column k; the
+    // swaps move whole rows of this column and are recorded for the later
+    // ones. The pivot search walks one contiguous block at stride b.
+    bool factorColumn(T* column, size_t k, PivotProduct<T>& product) 
+    {
+        const size_t k0 = k * b;
+        const size_t cols = extent(k);
+        
+        for (size_t c = 0; c < cols; ++c) 
+        {
+            const size_t g = k0 + c;
+            size_t pivot_row = g;
+            T max_val = ScalarTraits<T>::abs(column[g * b + c]);
+            
+            for (size_t i = g + 1; i < n; ++i) 
+            {
+                T val = ScalarTraits<T>::abs(column[i * b + c]);
+                if (val > max_val) 
+                {
+                    max_val = val;
+                    pivot_row = i;
+                }
+            }
+            
+            pivots[g] = pivot_row;
+            if (pivot_row != g) 
+            {
+                std::swap_ranges(column + g * b, column + g * b + b, column + pivot_row * b);
+                product.negate();
+            }
+            
+            const T* row_g = column + g * b;
+            T pivot_val = row_g[c];
+            
+            if (ScalarTraits<T>::abs(pivot_val) < T(1e-15L)) 
+            {
+                return false;
+            }
+            
+            product.multiply(pivot_val);
+            
+            for (size_t i = g + 1; i < n; ++i) 
+            {
+                T* row_i = column + i * b;
+                T factor = row_i[c] / pivot_val;
+                row_i[c] = factor;
+                
+                for (size_t j = c + 1; j < cols; ++j) 
+                {
+                    row_i[j] -= factor * row_g[j];
+                }
+            }
+        }
+        
+        return true;
+    }
+    
+private:
+    size_t extent(size_t t) const { return std::min(b, n - t * b); }
+    
+    const size_t n;
+    const size_t b;
+    const size_t nt;
+    
+    std::vector<size_t> pivots;
+    std::unique_ptr<ThreadPool> pool;
+    AlignedArray<T> packed;
+};
+
+} // namespace LinearAlgebra
+
+#endif // TILE_COLUMN_LU_H
@@ -0,0 +1,62 @@
+#include "determinant.h"
+#include "tiled_matrix.h"
+#include "tile_column_lu.h"
+#include "engines.h"
+
+namespace LinearAlgebra 
+{
+
+namespace 
+{
+
+// Left-looking LU in tile-major memory, the in-memory counterpart of the
+// out-of-core engine: tile column k is updated with every finished panel
+// j < k and then factored. Both the pivot search and the tile updates run
+// over one contiguous tile column, so the hardware prefetcher sees plain
+// sequential streams rather than n row strides.
+template <typename T>
+PivotProduct<T> factorTileMajor(TiledMatrix<T>& matrix, size_t threads) 
+{
+    PivotProduct<T> product;
+    const size_t nt = matrix.getTileCount();
+    TileColumnLu<T> steps(matrix.getSize(), matrix.getTileSize(), threads);
+    
+    for (size_t k = 0; k < nt; ++k) 
+    {
+        T* column = matrix.tile(0, k);
+        for (size_t j = 0; j < k; ++j) 
+        {
+            steps.applyPanel(column, matrix.tile(j, j), j, k);
+        }
+        
+        if (!steps.factorColumn(column, k, product)) 
+        {
+            product.markSingular();
+            return product;
+        }
+    }
+    return product;
+}
+
+} // namespace
+
+template <typename T>
+PivotProduct<T> Engines::tileMajor(MatrixView<const T> matrix, size_t tileSize, size_t threads) 
+{
+    TiledMatrix<T> tiled = TiledMatrix<T>::fromRowMajor(matrix, tileSize, AllocationPolicy{ true, &BufferPool::shared() });
+    return factorTileMajor(tiled, threads);
+}
+
+template <typename T>
+T DeterminantCalculator::calculateTileMajorDeterminant(TiledMatrix<T>& matrix, size_t threads) 
+{ 
+    return factorTileMajor(matrix, threads).value(); 
+}
+
+#define HWMX_INSTANTIATE(T) \
+    template PivotProduct<T> Engines::tileMajor(MatrixView<const T>, size_t, size_t); \
+    template T DeterminantCalculator::calculateTileMajorDeterminant(TiledMatrix<T>&, size_t);
+HWMX_FOR_EACH_SCALAR(HWMX_INSTANTIATE)
+#undef HWMX_INSTANTIATE
+
+} // namespace LinearAlgebra
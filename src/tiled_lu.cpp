@@ -0,0 +1,261 @@
+#include "determinant.h"
+#include "work_stealing_pool.h"
+#include "lu_kernels.h"
+#include "engines.h"
+#include "scalar_traits.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace LinearAlgebra 
+{
+
+namespace 
+{
+
+// Tile LU as a task graph. For step k with tile columns j > k and tile rows i > k:
+//
+//   panel(k)      factor tile column k with partial pivoting
+//                 after update(k-1, i, k) for every i >= k
+//   solve(k, j)   apply the pivots of panel(k) to tile column j, then
+//                 U(k, j) = L(k, k)^-1 A(k, j)
+//                 after panel(k) and update(k-1, i, j) for every i >= k
+//   update(k,i,j) A(i, j) -= L(i, k) U(k, j)
+//                 after solve(k, j)
+//
+// Nothing waits for a whole step to finish, so panel(k + 1) starts as soon
+// as tile column k + 1 is up to date while the rest of step k is still
+// running; that lookahead keeps threads busy near the bottom-right corner.
+template <typename T>
+class TileGraph 
+{
+public:
+    TileGraph(MatrixView<T> matrix, size_t tileSize, WorkStealingPool& pool)
+        : matrix(matrix), pool(pool), n(matrix.getSize()), ld(matrix.getStride()), nb(tileSize),
+          nt((n + tileSize - 1) / tileSize),
+          pivots(n), panelProduct(nt),
+          panelWaiting(nt), solveWaiting(nt * nt) 
+    {
+        for (size_t k = 0; k < nt; ++k) 
+        {
+            panelWaiting[k].store(k == 0 ? 0 : nt - k, std::memory_order_relaxed);
+            for (size_t j = k + 1; j < nt; ++j) 
+            {
+                solveWaiting[k * nt + j].store(k == 0 ? 1 : 1 + nt - k, std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    PivotProduct<T> run() 
+    {
+        pool.spawn([this] { panel(0); });
+        pool.wait();
+        
+        PivotProduct<T> product;
+        if (singular.load()) 
+        {
+            product.markSingular();
+            return product;
+        }
+        
+        applyLeftSwaps();
+        
+        for (const PivotProduct<T>& partial : panelProduct) 
+        {
+            product.multiply(partial);
+        }
+        return product;
+    }
+    
+private:
+    size_t begin(size_t t) const { return t * nb; }
+    size_t extent(size_t t) const { return std::min(nb, n - t * nb); }
+    T* tile(size_t i, size_t j) const { return matrix.getData() + begin(i) * ld + begin(j); }
+    
+    void panel(size_t k) 
+    {
+        if (!singular.load(std::memory_order_relaxed)) 
+        {
+            factorPanel(k);
+        }
+        for (size_t j = k + 1; j < nt; ++j) 
+        {
+            release(solveWaiting[k * nt + j], [this, k, j] { solve(k, j); });
+        }
+    }
+    
+    void solve(size_t k, size_t j) 
+    {
+        if (!singular.load(std::memory_order_relaxed)) 
+        {
+            const size_t k0 = begin(k);
+            const size_t kb = extent(k);
+            const size_t cols = extent(j);
+            T* a = matrix.getData();
+            
+            for (size_t r = k0; r < k0 + kb; ++r) 
+            {
+                if (pivots[r] != r) 
+                {
+                    std::swap_ranges(a + r * ld + begin(j), a + r * ld + begin(j) + cols, a + pivots[r] * ld + begin(j));
+                }
+            }
+            LuKernels::solveUnitLower(tile(k, k), ld, tile(k, j), ld, kb, cols);
+        }
+        for (size_t i = k + 1; i < nt; ++i) 
+        {
+            pool.spawn([this, k, i, j] { update(k, i, j); });
+        }
+    }
+    
+    void update(size_t k, size_t i, size_t j) 
+    {
+        if (!singular.load(std::memory_order_relaxed)) 
+        {
+            const size_t kb = extent(k);
+            const size_t cols = extent(j);
+            thread_local std::vector<T> packed;
+            packed.resize(kb * cols);
+            
+            LuKernels::packTransposed(tile(k, j), ld, kb, cols, packed.data());
+            LuKernels::multiplySubtract(tile(i, j), ld, tile(i, k), ld, packed.data(), extent(i), cols, kb);
+        }
+        if (j == k + 1) 
+        {
+            release(panelWaiting[j], [this, j] { panel(j); });
+        }
+        else 
+        {
+            release(solveWaiting[(k + 1) * nt + j], [this, k, j] { solve(k + 1, j); });
+        }
+    }
+    
+    template <typename Task>
+    void release(std::atomic<size_t>& waiting, Task task) 
+    {
+        if (waiting.fetch_sub(1, std::memory_order_acq_rel) == 1) 
+        {
+            pool.spawn(task);
+        }
+    }
+    
+    // Partial pivoting inside tile column k; swaps stay within that column
+    // and are recorded so solve() can replay them on the columns to the right.
+    void factorPanel(size_t k) 
+    {
+        const size_t k0 = begin(k);
+        const size_t kb = extent(k);
+        T* a = matrix.getData();
+        
+        for (size_t c = k0; c < k0 + kb; ++c) 
+        {
+            size_t pivot_row = c;
+            T max_val = ScalarTraits<T>::abs(a[c * ld + c]);
+            
+            for (size_t i = c + 1; i < n; ++i) 
+            {
+                T val = ScalarTraits<T>::abs(a[i * ld + c]);
+                if (val > max_val) 
+                {
+                    max_val = val;
+                    pivot_row = i;
+                }
+            }
+            
+            pivots[c] = pivot_row;
+            if (pivot_row != c) 
+            {
+                std::swap_ranges(a + c * ld + k0, a + c * ld + k0 + kb, a + pivot_row * ld + k0);
+                panelProduct[k].negate();
+            }
+            
+            const T* row_c = a + c * ld;
+            T pivot_val = row_c[c];
+            
+            if (ScalarTraits<T>::abs(pivot_val) < T(1e-15L)) 
+            {
+                singular.store(true);
+                return;
+            }
+            
+            panelProduct[k].multiply(pivot_val);
+            
+            for (size_t i = c + 1; i < n; ++i) 
+            {
+                T* row_i = a + i * ld;
+                T factor = row_i[c] / pivot_val;
+                row_i[c] = factor;
+                
+                for (size_t j = c + 1; j < k0 + kb; ++j) 
+                {
+                    row_i[j] -= factor * row_c[j];
+                }
+            }
+        }
+    }
+    
+    // Bring the L factor in line with the final row order, as LAPACK's getrf does
+    void applyLeftSwaps() 
+    {
+        T* a = matrix.getData();
+        for (size_t k = 1; k < nt; ++k) 
+        {
+            for (size_t r = begin(k); r < begin(k) + extent(k); ++r) 
+            {
+                if (pivots[r] != r) 
+                {
+                    std::swap_ranges(a + r * ld, a + r * ld + begin(k), a + pivots[r] * ld);
+                }
+            }
+        }
+    }
+    
+    MatrixView<T> matrix;
+    WorkStealingPool& pool;
+    const size_t n;
+    const size_t ld;
+    const size_t nb;
+    const size_t nt;
+    
+    std::vector<size_t> pivots;
+    std::vector<PivotProduct<T>> panelProduct;
+    std::vector<std::atomic<size_t>> panelWaiting;
+    std::vector<std::atomic<size_t>> solveWaiting;
+    std::atomic<bool> singular{false};
+};
+
+} // namespace
+
+template <typename T>
+PivotProduct<T> Engines::tiled(MatrixView<T> matrix, size_t tileSize, size_t threads) 
+{
+    const size_t n = matrix.getSize();
+    
+    if (tileSize == 0) 
+    {
+        throw std::invalid_argument("Block sizes must be positive");
+    }
+    
+    PivotProduct<T> product;
+    
+    if (n == 0) return product;
+    if (n == 1) 
+    {
+        product.multiply(matrix(0, 0));
+        return product;
+    }
+    
+    WorkStealingPool pool(threads);
+    TileGraph<T> graph(matrix, tileSize, pool);
+    return graph.run();
+}
+
+#define HWMX_INSTANTIATE(T) \
+    template PivotProduct<T> Engines::tiled(MatrixView<T>, size_t, size_t);
+HWMX_FOR_EACH_SCALAR(HWMX_INSTANTIATE)
+#undef HWMX_INSTANTIATE
+
+} // namespace LinearAlgebra
@@ -0,0 +1,131 @@
+#include "tiled_matrix.h"
+#include "scalar_traits.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace LinearAlgebra 
+{
+
+template <typename T>
+TiledMatrix<T>::TiledMatrix(size_t n, size_t tileSize, const AllocationPolicy& policy)
+    : size(n), tileSize(tileSize), tiles(tileSize ? (n + tileSize - 1) / tileSize : 0) 
+{
+    if (tileSize == 0) 
+    {
+        throw std::invalid_argument("Block sizes must be positive");
+    }
+    data = allocateAligned<T>(tiles * tiles * tileSize * tileSize, policy);
+}
+
+template <typename T>
+TiledMatrix<T> TiledMatrix<T>::fromRowMajor(MatrixView<const T> matrix, size_t tileSize, const AllocationPolicy& policy) 
+{
+    if (!matrix.isSquare()) 
+    {
+        throw std::invalid_argument("Tiled copy of a non-square view");
+    }
+    
+    // Only edge tiles have padding; without it every element is written below
+    AllocationPolicy fill = policy;
+    fill.zeroFill = tileSize != 0 && matrix.getSize() % tileSize != 0;
+    TiledMatrix tiled(matrix.getSize(), tileSize, fill);
+    
+    const size_t n = tiled.size;
+    const size_t b = tileSize;
+    // Each source row is read once, front to back, and scattered into the
+    // rows of the tiles of its tile row
+    for (size_t i = 0; i < n; ++i) 
+    {
+        const T* source = &matrix(i, 0);
+        const size_t ti = i / b;
+        const size_t r = i % b;
+        for (size_t tj = 0; tj < tiled.tiles; ++tj) 
+        {
+            const size_t j0 = tj * b;
+            const size_t count = std::min(b, n - j0);
+            std::copy(source + j0, source + j0 + count, tiled.tile(ti, tj) + r * b);
+        }
+    }
+    return tiled;
+}
+
+template <typename T>
+void TiledMatrix<T>::toRowMajor(MatrixView<T> matrix) const 
+{
+    if (matrix.getRows() != size || matrix.getCols() != size) 
+    {
+        throw std::invalid_argument("Row-major copy into a view of another size");
+    }
+    
+    const size_t b = tileSize;
+    for (size_t i = 0; i < size; ++i) 
+    {
+        T* target = &matrix(i, 0);
+        const size_t ti = i / b;
+        const size_t r = i % b;
+        for (size_t tj = 0; tj < tiles; ++tj) 
+        {
+            const size_t j0 = tj * b;
+            const size_t count = std::min(b, size - j0);
+            const T* row = tile(ti, tj) + r * b;
+            std::copy(row, row + count, target + j0);
+        }
+    }
+}
+
+template <typename T>
+Matrix<T> TiledMatrix<T>::toMatrix() const 
+{
+    Matrix<T> matrix(size, AllocationPolicy{ false });
+    toRowMajor(matrix.view());
+    return matrix;
+}
+
+template <typename T>
+T& TiledMatrix<T>::operator()(size_t i, size_t j) 
+{ 
+    return tile(i / tileSize, j / tileSize)[(i % tileSize) * tileSize + j % tileSize]; 
+}
+
+template <typename T>
+const T& TiledMatrix<T>::operator()(size_t i, size_t j) const 
+{ 
+    return tile(i / tileSize, j / tileSize)[(i % tileSize) * tileSize + j % tileSize]; 
+}
+
+template <typename T>
+T* TiledMatrix<T>::tile(size_t row, size_t column) 
+{ 
+    return data.get() + (column * tiles + row) * tileSize * tileSize; 
+}
+
+template <typename T>
+const T* TiledMatrix<T>::tile(size_t row, size_t column) const 
+{ 
+    return data.get() + (column * tiles + row) * tileSize * tileSize; 
+}
+
+template <typename T>
+size_t TiledMatrix<T>::getSize() const 
+{ 
+    return size; 
+}
+
+template <typename T>
+size_t TiledMatrix<T>::getTileSize() const 
+{ 
+    return tileSize; 
+}
+
+template <typename T>
+size_t TiledMatrix<T>::getTileCount() const 
+{ 
+    return tiles; 
+}
+
+#define HWMX_INSTANTIATE(T) \
+    template class TiledMatrix<T>;
+HWMX_FOR_EACH_SCALAR(HWMX_INSTANTIATE)
+#undef HWMX_INSTANTIATE
+
+} // namespace LinearAlgebra
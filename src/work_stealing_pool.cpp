@@ -0,0 +1,157 @@
+#include "work_stealing_pool.h"
+
+namespace LinearAlgebra 
+{
+
+namespace 
+{
+
+thread_local const WorkStealingPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(size_t threads) 
+{
+    const size_t count = threads == 0 ? 1 : threads;
+    for (size_t i = 0; i < count; ++i) 
+    {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (size_t worker = 1; worker < count; ++worker) 
+    {
+        workers.emplace_back(&WorkStealingPool::workerLoop, this, worker);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() 
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    sleepCondition.notify_all();
+    for (std::thread& worker : workers) 
+    {
+        worker.join();
+    }
+}
+
+size_t WorkStealingPool::getThreadCount() const 
+{
+    return queues.size();
+}
+
+void WorkStealingPool::spawn(Task task) 
+{
+    const size_t worker = currentPool == this ? currentWorker : 0;
+    
+    pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(queues[worker]->mutex);
+        queues[worker]->tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1, std::memory_order_release);
+    
+    // Taking the sleep mutex orders this wake-up after any sleeper's check
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    sleepCondition.notify_one();
+}
+
+bool WorkStealingPool::tryRunOne(size_t worker) 
+{
+    Task task;
+    
+    {
+        Queue& own = *queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) 
+        {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+        }
+    }
+    
+    for (size_t offset = 1; !task && offset < queues.size(); ++offset) 
+    {
+        Queue& victim = *queues[(worker + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) 
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+        }
+    }
+    
+    if (!task) return false;
+    queued.fetch_sub(1, std::memory_order_relaxed);
+    
+    try 
+    {
+        task();
+    } 
+    catch (...) 
+    {
+        std::lock_guard<std::mutex> lock(failureMutex);
+        if (!failure) failure = std::current_exception();
+    }
+    
+    if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) 
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        sleepCondition.notify_all();
+    }
+    return true;
+}
+
+void WorkStealingPool::workerLoop(size_t worker) 
+{
+    currentPool = this;
+    currentWorker = worker;
+    
+    for (;;) 
+    {
+        if (tryRunOne(worker)) continue;
+        
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCondition.wait(lock, [this] 
+        { 
+            return stopping || queued.load(std::memory_order_acquire) > 0; 
+        });
+        if (stopping) return;
+    }
+}
+
+void WorkStealingPool::wait() 
+{
+    const WorkStealingPool* outerPool = currentPool;
+    const size_t outerWorker = currentWorker;
+    currentPool = this;
+    currentWorker = 0;
+    
+    while (pending.load(std::memory_order_acquire) > 0) 
+    {
+        if (tryRunOne(0)) continue;
+        
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCondition.wait(lock, [this] 
+        { 
+            return queued.load(std::memory_order_acquire) > 0 || pending.load(std::memory_order_acquire) == 0; 
+        });
+    }
+    
+    currentPool = outerPool;
+    currentWorker = outerWorker;
+    
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(failureMutex);
+        std::swap(error, failure);
+    }
+    if (error) 
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace LinearAlgebra
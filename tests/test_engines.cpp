@@ -0,0 +1,581 @@
+// Every LU engine against the unblocked one on the same random matrices in
+// every scalar type, over orders that hit the panel and tile edges and over
+// thread counts. Around them: views, workspaces and the row order of the
+// factorization, the row layout and allocation policies, the tile-major
+// layout and the out-of-core tile store, the batched and compile-time small-matrix APIs, determinants
+// known in closed form and ones far outside the range of long double.
+
+#include "test_support.h"
+#include "determinant.h"
+#include "file_matrix.h"
+#include "fixed_matrix.h"
+#include "tiled_matrix.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace LinearAlgebra;
+using DeterminantCalculator::Engine;
+using DeterminantCalculator::LogDeterminant;
+using DeterminantCalculator::Options;
+
+namespace 
+{
+
+const Engine kLuEngines[] = 
+{
+    Engine::Unblocked, Engine::Blocked, Engine::Simd, Engine::Tiled, Engine::TileMajor, Engine::Recursive, Engine::Adaptive
+};
+
+const size_t kOrders[] = { 0, 1, 2, 3, 5, 16, 17, 33, 64, 65, 130 };
+
+// simd works in double whatever T is, and adaptive may keep its result
+template <typename T>
+long double tolerance(Engine engine) 
+{
+    if (std::is_same_v<T, float>) return 1e-4L;
+    if (engine == Engine::Simd || engine == Engine::Adaptive || std::is_same_v<T, double>) return 1e-10L;
+    return 1e-13L;
+}
+
+template <typename T>
+LogDeterminant reference(const Matrix<T>& matrix) 
+{
+    Matrix<T> work = matrix.copy();
+    return DeterminantCalculator::logDeterminant(work);
+}
+
+// Largest |(L U)(i, j) - A(permutation[i], j)| for unit lower L and upper
+// U stored in `factors` in the final row order
+long double factorResidual(const Matrix<long double>& input, const Matrix<long double>& factors, const std::vector<size_t>& permutation) 
+{
+    const size_t n = input.getSize();
+    long double largest = 0.0L;
+    for (size_t i = 0; i < n; ++i) 
+    {
+        for (size_t j = 0; j < n; ++j) 
+        {
+            long double sum = i <= j ? factors(i, j) : 0.0L;
+            for (size_t k = 0; k < std::min(i, j + 1); ++k) sum += factors(i, k) * factors(k, j);
+            largest = std::max(largest, std::fabs(sum - input(permutation[i], j)));
+        }
+    }
+    return largest;
+}
+
+template <typename T>
+void checkEnginesAgree(const char* type) 
+{
+    for (size_t n : kOrders) 
+    {
+        const Matrix<T> matrix = TestSupport::randomMatrix<T>(n, 1000 + n);
+        const LogDeterminant expected = reference(matrix);
+        
+        for (Engine engine : kLuEngines) 
+        {
+            for (size_t threads : { size_t(1), size_t(3) }) 
+            {
+                // Small panels and tiles put edge blocks into every order above
+                Options options;
+                options.engine = engine;
+                options.panelWidth = 16;
+                options.tileSize = 32;
+                options.threads = threads;
+                
+                Matrix<T> work = matrix.copy();
+                const LogDeterminant result = DeterminantCalculator::logDeterminant(work, options);
+                CHECK_MSG(TestSupport::sameLogDeterminant(result, expected, tolerance<T>(engine)), 
+                          type << " " << DeterminantCalculator::engineName(engine) << " n=" << n << " threads=" << threads << " log " 
+                          << static_cast<double>(result.logAbs) << " vs " << static_cast<double>(expected.logAbs));
+            }
+        }
+        
+        // The simd entry point reads its input without modifying it and
+        // returns double, so float input does not overflow at n ~ 100
+        const double simd = DeterminantCalculator::calculateSimdDeterminant(matrix, 2);
+        const LogDeterminant simdLog = { simd > 0 ? 1 : simd < 0 ? -1 : 0, std::log(std::fabs(static_cast<long double>(simd))) };
+        CHECK_MSG(TestSupport::sameLogDeterminant(simdLog, expected, tolerance<T>(Engine::Simd)), type << " calculateSimdDeterminant n=" << n);
+    }
+}
+
+template <typename T>
+void checkSingular() 
+{
+    // Row 7 repeats row 2. The unblocked engines eliminate it to exact
+    // zeros; blocked kernels may round the two copies differently, which
+    // leaves a determinant many orders below that of the matrix before
+    const Matrix<T> regular = TestSupport::randomMatrix<T>(40, 7);
+    Matrix<T> matrix = regular.copy();
+    for (size_t j = 0; j < 40; ++j) matrix(7, j) = matrix(2, j);
+    
+    for (Engine engine : kLuEngines) 
+    {
+        Options options;
+        options.engine = engine;
+        options.panelWidth = 16;
+        options.tileSize = 16;
+        Matrix<T> work = matrix.copy();
+        Matrix<T> before = regular.copy();
+        const T singular = DeterminantCalculator::calculateDeterminant(work, options);
+        const T scale = DeterminantCalculator::calculateDeterminant(before, options);
+        const bool exactZero = engine == Engine::Unblocked || engine == Engine::Recursive || engine == Engine::Simd;
+        CHECK_MSG(exactZero ? singular == T(0) : std::fabs(static_cast<double>(singular)) < 1e-12 * std::fabs(static_cast<double>(scale)), 
+                  DeterminantCalculator::engineName(engine) << " " << static_cast<double>(singular));
+                  
+        Matrix<T> zero(20);
+        const LogDeterminant log = DeterminantCalculator::logDeterminant(zero, options);
+        CHECK_MSG(log.sign == 0 && std::isinf(log.logAbs) && log.logAbs < 0, DeterminantCalculator::engineName(engine));
+    }
+}
+
+void checkKnownDeterminants(const std::string& dataDirectory) 
+{
+    // 2 I has det 2^n: a power of two, exact in every engine
+    for (Engine engine : kLuEngines) 
+    {
+        Options options;
+        options.engine = engine;
+        Matrix<double> twice(50);
+        for (size_t i = 0; i < 50; ++i) twice(i, i) = 2.0;
+        CHECK_MSG(DeterminantCalculator::calculateDeterminant(twice, options) == std::ldexp(1.0, 50), DeterminantCalculator::engineName(engine));
+    }
+    
+    // Swapping two rows of I flips the sign
+    Matrix<long double> swapped(9);
+    for (size_t i = 0; i < 9; ++i) swapped(i, i) = 1.0L;
+    swapped.swapRows(3, 8);
+    CHECK(DeterminantCalculator::calculateDeterminant(swapped) == -1.0L);
+    
+    // Files made by generator.py, named after their determinants
+    const std::pair<const char*, double> files[] = { { "matrix_5_5.00.txt", 5.0 }, { "matrix_300_123456.00.txt", 123456.0 } };
+    for (const auto& [name, determinant] : files) 
+    {
+        for (Engine engine : kLuEngines) 
+        {
+            Options options;
+            options.engine = engine;
+            Matrix<long double> matrix = MatrixReader::readFromFile<long double>(dataDirectory + "/" + name);
+            const long double result = DeterminantCalculator::calculateDeterminant(matrix, options);
+            CHECK_MSG(std::fabs(result / determinant - 1.0L) < 1e-8L, name << " " << DeterminantCalculator::engineName(engine) << " " 
+                      << static_cast<double>(result));
+        }
+    }
+    
+    // det H_n = c_n^4 / c_2n with c_n = 1! 2! ... (n-1)! (Hilbert). Cond(H_8)
+    // is about 1.5e10, so the adaptive engine has to leave double behind.
+    const size_t n = 8;
+    Matrix<long double> hilbert(n);
+    for (size_t i = 0; i < n; ++i) 
+    {
+        for (size_t j = 0; j < n; ++j) hilbert(i, j) = 1.0L / static_cast<long double>(i + j + 1);
+    }
+    auto logSuperfactorial = [](size_t m) 
+    {
+        long double sum = 0.0L;
+        for (size_t k = 1; k < m; ++k) sum += std::lgamma(static_cast<long double>(k + 1));
+        return sum;
+    };
+    const long double exact = 4.0L * logSuperfactorial(n) - logSuperfactorial(2 * n);
+    Options adaptive;
+    adaptive.engine = Engine::Adaptive;
+    const LogDeterminant result = DeterminantCalculator::logDeterminant(hilbert, adaptive);
+    CHECK_MSG(result.sign == 1 && std::fabs(result.logAbs - exact) < 1e-7L, static_cast<double>(result.logAbs) << " vs " << static_cast<double>(exact));
+    
+    // Adaptive returns the simd result bit for bit when it stays in double,
+    // so differing from it shows the escalation, and matching it shows that
+    // well-conditioned inputs, random ones included, are kept in double
+    Options simd;
+    simd.engine = Engine::Simd;
+    CHECK(DeterminantCalculator::logDeterminant(hilbert, simd).logAbs != result.logAbs);
+    std::vector<Matrix<double>> conditioned;
+    for (size_t order : { size_t(100), size_t(300), size_t(600) }) 
+    {
+        conditioned.push_back(TestSupport::randomMatrix<double>(order, order));
+    }
+    conditioned.push_back(MatrixReader::readFromFile<double>(dataDirectory + "/matrix_300_123456.00.txt"));
+    for (Matrix<double>& matrix : conditioned) 
+    {
+        Matrix<double> copy = matrix.copy();
+        const LogDeterminant kept = DeterminantCalculator::logDeterminant(matrix, adaptive);
+        const LogDeterminant reference = DeterminantCalculator::logDeterminant(copy, simd);
+        CHECK_MSG(kept.sign == reference.sign && kept.logAbs == reference.logAbs, "adaptive left double at n=" << matrix.getSize());
+    }
+}
+
+void checkRange() 
+{
+    // diag(10^e, ..., 10^e) of order n has det 10^(n e): past long
+    // double's 10^4932 for 40 entries of 10^200, below its smallest
+    // subnormal for 420 of 10^-12 (above the singularity threshold), yet
+    // every factor is an ordinary double
+    const std::pair<int, size_t> cases[] = { { 200, 40 }, { -12, 420 } };
+    for (const auto& [exponent, n] : cases) 
+    {
+        for (Engine engine : kLuEngines) 
+        {
+            Options options;
+            options.engine = engine;
+            options.panelWidth = 16;
+            options.tileSize = 16;
+            Matrix<long double> diagonal(n);
+            for (size_t i = 0; i < n; ++i) diagonal(i, i) = std::pow(10.0L, exponent);
+            diagonal.swapRows(0, n - 1);
+            const LogDeterminant log = DeterminantCalculator::logDeterminant(diagonal, options);
+            const long double expected = static_cast<long double>(n) * exponent * std::log(10.0L);
+            CHECK_MSG(log.sign == -1 && std::fabs(log.logAbs / expected - 1.0L) < 1e-12L, 
+                      DeterminantCalculator::engineName(engine) << " 10^" << exponent << " log " << static_cast<double>(log.logAbs));
+        }
+    }
+}
+
+void checkEntryPoints() 
+{
+    const Matrix<long double> matrix = TestSupport::randomMatrix<long double>(70, 42);
+    const LogDeterminant expected = reference(matrix);
+    
+    // Workspace overloads leave the input alone and agree with the
+    // destructive call, also when one workspace serves several orders
+    Workspace<long double> workspace;
+    for (Engine engine : { Engine::Unblocked, Engine::Blocked, Engine::Simd }) 
+    {
+        Options options;
+        options.engine = engine;
+        options.threads = 2;
+        for (size_t n : { size_t(70), size_t(12), size_t(70) }) 
+        {
+            const MatrixView<const long double> block = matrix.view().block(0, 0, n, n);
+            Matrix<long double> copy(n);
+            for (size_t i = 0; i < n; ++i) std::copy(&block(i, 0), &block(i, 0) + n, &copy(i, 0));
+            
+            const LogDeterminant result = DeterminantCalculator::logDeterminant(block, options, workspace);
+            const LogDeterminant direct = DeterminantCalculator::logDeterminant(copy, options);
+            CHECK_MSG(TestSupport::sameLogDeterminant(result, direct, 0.0L), DeterminantCalculator::engineName(engine) << " n=" << n);
+        }
+    }
+    CHECK(workspace.getCapacity() >= 70 * paddedStride<long double>(70));
+    bool intact = true;
+    const Matrix<long double> again = TestSupport::randomMatrix<long double>(70, 42);
+    for (size_t i = 0; i < 70; ++i) 
+    {
+        for (size_t j = 0; j < 70; ++j) intact = intact && matrix(i, j) == again(i, j);
+    }
+    CHECK(intact);
+    
+    // A view of a block factors just that block
+    Matrix<long double> large = TestSupport::randomMatrix<long double>(90, 5);
+    Matrix<long double> corner(30);
+    for (size_t i = 0; i < 30; ++i) std::copy(&large(10 + i, 20), &large(10 + i, 20) + 30, &corner(i, 0));
+    const LogDeterminant cornerExpected = reference(corner);
+    CHECK(TestSupport::sameLogDeterminant(DeterminantCalculator::logDeterminant(large.view().block(10, 20, 30, 30)), cornerExpected, 1e-15L));
+    CHECK_THROWS(large.view().block(80, 0, 20, 20));
+    
+    // The reported row order is the one the factors are in: row i of L U
+    // is input row permutation[i]. Logical pivoting does the same arithmetic
+    // and reports the same order, but the unblocked engine leaves every row
+    // where it was, and the blocked engine leaves the multipliers of each
+    // finished panel in the order that panel was factored in.
+    const size_t n = matrix.getSize();
+    const size_t panel = 16;
+    std::vector<size_t> identity(n);
+    std::iota(identity.begin(), identity.end(), size_t(0));
+    for (Engine engine : { Engine::Unblocked, Engine::Blocked }) 
+    {
+        const char* name = DeterminantCalculator::engineName(engine);
+        Options options;
+        options.engine = engine;
+        options.panelWidth = panel;
+        Matrix<long double> swapped = matrix.copy();
+        std::vector<size_t> permutation;
+        const long double result = DeterminantCalculator::calculateDeterminant(swapped, options, permutation);
+        
+        std::vector<size_t> sorted = permutation;
+        std::sort(sorted.begin(), sorted.end());
+        CHECK_MSG(sorted == identity && permutation != identity, name);
+        CHECK_MSG(std::fabs(std::log(std::fabs(result)) - expected.logAbs) < 1e-12L, name);
+        CHECK_MSG(factorResidual(matrix, swapped, permutation) < 1e-14L, name);
+        
+        options.logicalPivoting = true;
+        Matrix<long double> logical = matrix.copy();
+        std::vector<size_t> logicalPermutation;
+        CHECK_MSG(DeterminantCalculator::calculateDeterminant(logical, options, logicalPermutation) == result, name << " logical");
+        CHECK_MSG(logicalPermutation == permutation, name << " logical");
+        
+        // Bring the logical factors into the final row order; they must then
+        // be the swapping run's factors bit for bit
+        Matrix<long double> factors(n);
+        if (engine == Engine::Unblocked) 
+        {
+            for (size_t i = 0; i < n; ++i) std::copy(&logical(permutation[i], 0), &logical(permutation[i], 0) + n, &factors(i, 0));
+        }
+        else 
+        {
+            // The swap made at each step, recovered from the permutation
+            std::vector<size_t> pivots(n);
+            std::vector<size_t> order = identity;
+            for (size_t r = 0; r < n; ++r) 
+            {
+                pivots[r] = static_cast<size_t>(std::find(order.begin() + r, order.end(), permutation[r]) - order.begin());
+                std::swap(order[r], order[pivots[r]]);
+            }
+            factors = logical.copy();
+            for (size_t k0 = 0; k0 < n; k0 += panel) 
+            {
+                const size_t k1 = std::min(k0 + panel, n);
+                for (size_t r = k1; r < n; ++r) std::swap_ranges(&factors(r, k0), &factors(r, k0) + (k1 - k0), &factors(pivots[r], k0));
+            }
+        }
+        bool same = true;
+        for (size_t i = 0; i < n; ++i) 
+        {
+            for (size_t j = 0; j < n; ++j) same = same && factors(i, j) == swapped(i, j);
+        }
+        CHECK_MSG(same, name << " logical");
+        CHECK_MSG(factorResidual(matrix, factors, permutation) < 1e-14L, name << " logical");
+    }
+}
+
+void checkLayout() 
+{
+    // Rows on cache lines, with one more line where the stride would be a
+    // multiple of 1 KiB
+    CHECK(paddedStride<double>(5) == 8);
+    CHECK(paddedStride<double>(128) == 136);
+    CHECK(paddedStride<float>(256) == 272);
+    CHECK(paddedStride<double>(0) == 0);
+    for (size_t n : { size_t(1), size_t(5), size_t(128), size_t(130) }) 
+    {
+        const Matrix<double> matrix = TestSupport::randomMatrix<double>(n, 200 + n);
+        CHECK_MSG(matrix.getStride() == paddedStride<double>(n), "n=" << n);
+        bool aligned = true;
+        for (size_t i = 0; i < n; ++i) 
+        {
+            aligned = aligned && reinterpret_cast<uintptr_t>(&matrix(i, 0)) % kCacheLineBytes == 0;
+        }
+        CHECK_MSG(aligned, "n=" << n);
+        
+        // An explicit leading dimension, unpadded or wider, factors the same
+        for (size_t leading : { n, n + 3 }) 
+        {
+            Matrix<double> other(n, leading);
+            for (size_t i = 0; i < n; ++i) 
+            {
+                for (size_t j = 0; j < n; ++j) other(i, j) = matrix(i, j);
+            }
+            Matrix<double> copy = matrix.copy();
+            CHECK_MSG(other.getStride() == leading, "n=" << n);
+            CHECK_MSG(DeterminantCalculator::calculateDeterminant(other) == DeterminantCalculator::calculateDeterminant(copy), 
+                      "n=" << n << " leading=" << leading);
+        }
+    }
+}
+
+void checkAllocation() 
+{
+    // A released block comes back for the next request of its size, and
+    // trim() gives everything back
+    BufferPool pool;
+    void* block = pool.acquire(100000);
+    pool.release(block, 100000);
+    CHECK(pool.getCachedBytes() >= 100000);
+    CHECK(pool.acquire(100000) == block);
+    CHECK(pool.getCachedBytes() == 0);
+    pool.release(block, 100000);
+    
+    // Matrices drawn from the pool: a recycled block still comes back
+    // zero-filled unless the policy says otherwise, and either way the
+    // buffer factors like a heap one
+    const Matrix<double> matrix = TestSupport::randomMatrix<double>(100, 77);
+    Matrix<double> copy = matrix.copy();
+    const double expected = DeterminantCalculator::calculateDeterminant(copy);
+    for (bool zeroFill : { true, false }) 
+    {
+        AllocationPolicy policy;
+        policy.zeroFill = zeroFill;
+        policy.pool = &pool;
+        for (int round = 0; round < 2; ++round) 
+        {
+            Matrix<double> pooled(100, policy);
+            bool zeros = true;
+            for (size_t i = 0; i < 100; ++i) 
+            {
+                for (size_t j = 0; j < 100; ++j) zeros = zeros && pooled(i, j) == 0.0;
+            }
+            CHECK_MSG(zeros || !zeroFill, "round " << round);
+            for (size_t i = 0; i < 100; ++i) 
+            {
+                for (size_t j = 0; j < 100; ++j) pooled(i, j) = matrix(i, j);
+            }
+            CHECK_MSG(DeterminantCalculator::calculateDeterminant(pooled) == expected, "zeroFill=" << zeroFill << " round " << round);
+        }
+    }
+    CHECK(pool.getCachedBytes() > 0);
+    pool.trim();
+    CHECK(pool.getCachedBytes() == 0);
+    
+    // Huge pages, NUMA placement and the parallel first-touch pass change
+    // where the pages live, never what the matrix holds. Where the system
+    // lacks huge pages or NUMA the policies fall back quietly.
+    std::vector<AllocationPolicy> policies(6);
+    policies[0].hugePages = HugePages::Transparent;
+    policies[1].hugePages = HugePages::Explicit;
+    policies[2].numa = NumaPlacement::Interleave;
+    policies[3].numa = NumaPlacement::Preferred;
+    policies[4].firstTouchThreads = 3;
+    policies[4].firstTouchRows = 16;
+    policies[5] = policies[4];
+    policies[5].zeroFill = false;
+    for (size_t k = 0; k < policies.size(); ++k) 
+    {
+        Matrix<double> placed(100, policies[k]);
+        bool zeros = true;
+        for (size_t i = 0; i < 100; ++i) 
+        {
+            for (size_t j = 0; j < 100; ++j) zeros = zeros && placed(i, j) == 0.0;
+        }
+        CHECK_MSG(zeros || !policies[k].zeroFill, "policy " << k);
+        for (size_t i = 0; i < 100; ++i) 
+        {
+            for (size_t j = 0; j < 100; ++j) placed(i, j) = matrix(i, j);
+        }
+        Matrix<double> copied = placed;
+        CHECK_MSG(DeterminantCalculator::calculateDeterminant(placed) == expected, "policy " << k);
+        CHECK_MSG(DeterminantCalculator::calculateDeterminant(copied) == expected, "copy of policy " << k);
+    }
+}
+
+void checkTileLayouts(const std::string& dataDirectory, const std::string& scratchDirectory) 
+{
+    const std::string path = scratchDirectory + "/engines_store.bin";
+    for (size_t n : { size_t(1), size_t(47), size_t(70) }) 
+    {
+        const Matrix<double> matrix = TestSupport::randomMatrix<double>(n, 300 + n);
+        const LogDeterminant expected = reference(matrix);
+        
+        // Tile-major round trip keeps every entry, padding included
+        TiledMatrix<double> tiled = TiledMatrix<double>::fromRowMajor(matrix.view(), 16);
+        const Matrix<double> back = tiled.toMatrix();
+        bool same = true;
+        for (size_t i = 0; i < n; ++i) 
+        {
+            for (size_t j = 0; j < n; ++j) same = same && back(i, j) == matrix(i, j) && tiled(i, j) == matrix(i, j);
+        }
+        CHECK_MSG(same, "n=" << n);
+        const double tileMajor = DeterminantCalculator::calculateTileMajorDeterminant(tiled, 2);
+        CHECK_MSG(std::fabs(std::log(std::fabs(tileMajor)) - expected.logAbs) < 1e-10L, "tile-major n=" << n);
+        
+        // Tiles read back as written, the edge tiles padded with zeros
+        {
+            FileMatrix<double> store = FileMatrix<double>::fromMatrix(path, matrix.view(), 16);
+            std::vector<double> tile(16 * 16);
+            const size_t last = store.getTileCount() - 1;
+            store.readTile(last, 0, tile.data());
+            const size_t row = n - 1 - last * 16;
+            CHECK_MSG(tile[row * 16] == matrix(n - 1, 0) && (row == 15 || tile[15 * 16] == 0.0), "n=" << n);
+        }
+        
+        // Factored out of core, reopened from the file each time
+        for (size_t threads : { size_t(1), size_t(2) }) 
+        {
+            FileMatrix<double> store = FileMatrix<double>::fromMatrix(path, matrix.view(), 16);
+            const LogDeterminant result = DeterminantCalculator::logOutOfCoreDeterminant(store, threads);
+            CHECK_MSG(TestSupport::sameLogDeterminant(result, expected, 1e-10L), "out-of-core n=" << n << " threads=" << threads);
+        }
+        CHECK_THROWS(FileMatrix<float>::open(path));
+        std::filesystem::remove(path);
+    }
+    
+    // Imported from text a row tile at a time
+    FileMatrix<long double> imported = FileMatrix<long double>::importText(dataDirectory + "/matrix_300_123456.00.txt", path, 64);
+    CHECK(imported.getSize() == 300 && imported.getTileCount() == 5);
+    CHECK(std::fabs(DeterminantCalculator::calculateOutOfCoreDeterminant(imported, 2) / 123456.0L - 1.0L) < 1e-8L);
+    std::filesystem::remove(path);
+}
+
+void checkBatch() 
+{
+    const size_t count = 37;   // not a multiple of any vector width
+    for (size_t n = 1; n <= 16; ++n) 
+    {
+        std::vector<double> batch(n * n * count);
+        std::vector<double> expected(count);
+        for (size_t b = 0; b < count; ++b) 
+        {
+            Matrix<double> matrix = TestSupport::randomMatrix<double>(n, 17 * n + b);
+            for (size_t i = 0; i < n; ++i) 
+            {
+                for (size_t j = 0; j < n; ++j) batch[(i * n + j) * count + b] = matrix(i, j);
+            }
+            expected[b] = DeterminantCalculator::calculateDeterminant(matrix);
+        }
+        
+        for (size_t threads : { size_t(1), size_t(3) }) 
+        {
+            std::vector<double> determinants(count);
+            DeterminantCalculator::calculateBatchDeterminants(batch.data(), n, count, determinants.data(), threads);
+            bool close = true;
+            for (size_t b = 0; b < count; ++b) 
+            {
+                close = close && std::fabs(determinants[b] - expected[b]) <= 1e-12 * std::max(1.0, std::fabs(expected[b]));
+            }
+            CHECK_MSG(close, "batch n=" << n << " threads=" << threads);
+        }
+    }
+}
+
+// Constant expressions: closed forms, Laplace and the unrolled elimination
+static_assert(FixedMatrix<1, int>(-3).determinant() == -3);
+static_assert(FixedMatrix<2, int>(1, 2, 3, 4).determinant() == -2);
+static_assert(FixedMatrix<3, long long>(2, 0, 1, 1, 3, 2, 1, 1, 2).determinant() == 6);
+static_assert(FixedMatrix<4, int>(0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0).determinant() == 1);
+static_assert(FixedMatrix<5, double>(0, 0, 0, 0, 2, 0, 0, 0, 2, 0, 0, 0, 2, 0, 0, 0, 2, 0, 0, 0, 2, 0, 0, 0, 0).determinant() == 32.0);
+static_assert(FixedMatrix<6, double>().determinant() == 0.0);
+
+template <size_t N>
+void checkFixedOrder() 
+{
+    const Matrix<long double> matrix = TestSupport::randomMatrix<long double>(N, 500 + N);
+    FixedMatrix<N> fixed;
+    for (size_t i = 0; i < N; ++i) 
+    {
+        for (size_t j = 0; j < N; ++j) fixed(i, j) = matrix(i, j);
+    }
+    Matrix<long double> work = matrix.copy();
+    const long double expected = DeterminantCalculator::calculateDeterminant(work);
+    CHECK_MSG(TestSupport::sameDeterminant(fixed.determinant(), expected, 1e-14L), "FixedMatrix<" << N << ">");
+}
+
+template <size_t... N>
+void checkFixed(std::index_sequence<N...>) 
+{ 
+    (checkFixedOrder<N + 1>(), ...); 
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) 
+{
+    const std::string dataDirectory = argc > 1 ? argv[1] : "data";
+    const std::string scratchDirectory = argc > 2 ? argv[2] : std::filesystem::temp_directory_path().string();
+    
+    checkEnginesAgree<float>("float");
+    checkEnginesAgree<double>("double");
+    checkEnginesAgree<long double>("long double");
+#ifdef __SIZEOF_FLOAT128__
+    checkEnginesAgree<__float128>("quad");
+#endif
+    checkSingular<double>();
+    checkSingular<long double>();
+    checkKnownDeterminants(dataDirectory);
+    checkRange();
+    checkEntryPoints();
+    checkLayout();
+    checkAllocation();
+    checkTileLayouts(dataDirectory, scratchDirectory);
+    checkBatch();
+    checkFixed(std::make_index_sequence<8>());
+    
+    return TestSupport::finish("engines");
+}
@@ -0,0 +1,308 @@
+// Readers and writers: text files read back exactly (sequentially, in
+// parallel chunks, through a pipe), binary matrix files and NumPy .npy
+// files round-tripped in every layout and precision they allow, and
+// malformed input of each kind rejected.
+
+#include "test_support.h"
+#include "determinant.h"
+#include "file_matrix.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace LinearAlgebra;
+
+namespace 
+{
+
+std::string scratch;
+
+std::string path(const std::string& name) 
+{ 
+    return scratch + "/readers_" + name; 
+}
+
+template <typename T, typename U>
+bool sameEntries(const Matrix<T>& a, const Matrix<U>& b) 
+{
+    if (a.getSize() != b.getSize()) return false;
+    for (size_t i = 0; i < a.getSize(); ++i) 
+    {
+        for (size_t j = 0; j < a.getSize(); ++j) 
+        {
+            if (static_cast<long double>(a(i, j)) != static_cast<long double>(b(i, j))) return false;
+        }
+    }
+    return true;
+}
+
+// Shortest text that reads back as the same double
+void writeText(const std::string& file, const Matrix<double>& matrix, const char* separator = " ", const char* newline = "\n") 
+{
+    std::ofstream out(file, std::ios::binary);
+    out << std::setprecision(17);
+    for (size_t i = 0; i < matrix.getSize(); ++i) 
+    {
+        for (size_t j = 0; j < matrix.getSize(); ++j) out << (j ? separator : "") << matrix(i, j);
+        out << newline;
+    }
+}
+
+// .npy as numpy.save writes it: magic, version, little-endian header
+// length, the dict padded with spaces and a newline to `align` bytes
+void writeNumpy(const std::string& file, const std::string& descr, bool fortranOrder, const std::string& shape, const void* data, size_t bytes,
+                int version = 1, size_t align = 64) 
+{
+    std::string dict = "{'descr': '" + descr + "', 'fortran_order': " + (fortranOrder ? "True" : "False") + ", 'shape': " + shape + ", }";
+    const size_t prefix = version == 1 ? 10 : 12;
+    dict.append((align - (prefix + dict.size() + 1) % align) % align, ' ');
+    dict.push_back('\n');
+    
+    std::ofstream out(file, std::ios::binary);
+    out.write("\x93NUMPY", 6);
+    out.put(static_cast<char>(version));
+    out.put(0);
+    const uint32_t length = static_cast<uint32_t>(dict.size());
+    for (size_t b = 0; b < (version == 1 ? 2u : 4u); ++b) out.put(static_cast<char>(length >> (8 * b)));
+    out << dict;
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+}
+
+template <typename S>
+std::vector<S> flatten(const Matrix<double>& matrix, bool fortranOrder) 
+{
+    const size_t n = matrix.getSize();
+    std::vector<S> values(n * n);
+    for (size_t i = 0; i < n; ++i) 
+    {
+        for (size_t j = 0; j < n; ++j) values[fortranOrder ? j * n + i : i * n + j] = static_cast<S>(matrix(i, j));
+    }
+    return values;
+}
+
+void checkText() 
+{
+    // Enough rows for the parallel reader to cut the file into many chunks
+    for (size_t n : { size_t(1), size_t(7), size_t(300) }) 
+    {
+        const Matrix<double> matrix = TestSupport::randomMatrix<double>(n, n);
+        writeText(path("text.txt"), matrix);
+        for (size_t threads : { size_t(1), size_t(4) }) 
+        {
+            const Matrix<double> read = MatrixReader::readFromFile<double>(path("text.txt"), AllocationPolicy(), threads);
+            CHECK_MSG(sameEntries(read, matrix), "n=" << n << " threads=" << threads);
+            CHECK(!read.isIntegral());
+        }
+        // 17 digits pin down the double, not the long double nearest to them
+        const Matrix<long double> wide = MatrixReader::readFromFile<long double>(path("text.txt"));
+        CHECK_MSG(static_cast<double>(wide(n - 1, 0)) == matrix(n - 1, 0) && wide.getSize() == n, "long double n=" << n);
+    }
+    
+    // CRLF line ends, tabs, a leading '+', trailing blank lines
+    Matrix<double> small(3);
+    const double values[] = { 1.5, -2, 3, 4, 5e-3, -6e10, 7, 8, 9 };
+    for (size_t k = 0; k < 9; ++k) small(k / 3, k % 3) = values[k];
+    {
+        std::ofstream out(path("crlf.txt"), std::ios::binary);
+        out << "+1.5\t-2 3\r\n4 5e-3 -6e10\r\n7 8 +9\r\n\r\n\n";
+    }
+    CHECK(sameEntries(MatrixReader::readFromFile<double>(path("crlf.txt")), small));
+    
+    // Integer entries set the flag the exact engines go by
+    Matrix<double> integers(4);
+    for (size_t i = 0; i < 4; ++i) 
+    {
+        for (size_t j = 0; j < 4; ++j) integers(i, j) = static_cast<double>(i * 4 + j) - 7.0;
+    }
+    writeText(path("int.txt"), integers);
+    const Matrix<double> readIntegers = MatrixReader::readFromFile<double>(path("int.txt"), AllocationPolicy(), 2);
+    CHECK(readIntegers.isIntegral() && sameEntries(readIntegers, integers));
+    
+    // A pipe has no size up front; the reader takes it in one pass
+    const std::string fifo = path("fifo");
+    std::filesystem::remove(fifo);
+    FILE* pipe = popen(("mkfifo " + fifo + " && cat " + path("int.txt") + " > " + fifo + " &").c_str(), "r");
+    if (pipe) 
+    {
+        pclose(pipe);
+        for (int wait = 0; wait < 100 && !std::filesystem::exists(fifo); ++wait) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        CHECK(sameEntries(MatrixReader::readFromFile<double>(fifo), integers));
+        std::filesystem::remove(fifo);
+    }
+    
+    // Malformed text
+    {
+        std::ofstream(path("ragged.txt")) << "1 2 3\n4 5\n6 7 8\n";
+        std::ofstream(path("short.txt")) << "1 2 3\n4 5 6\n";
+        std::ofstream(path("junk.txt")) << "1 2\n3 x\n";
+    }
+    CHECK_THROWS(MatrixReader::readFromFile<double>(path("ragged.txt")));
+    CHECK_THROWS(MatrixReader::readFromFile<double>(path("short.txt")));
+    CHECK_THROWS(MatrixReader::readFromFile<double>(path("short.txt"), AllocationPolicy(), 4));
+    CHECK_THROWS(MatrixReader::readFromFile<double>(path("ragged.txt"), AllocationPolicy(), 4));
+    CHECK_THROWS(MatrixReader::readFromFile<double>(path("junk.txt")));
+    CHECK_THROWS(MatrixReader::readFromFile<double>(path("missing.txt")));
+}
+
+void checkBinary() 
+{
+    const Matrix<double> matrix = TestSupport::randomMatrix<double>(45, 3);
+    MatrixWriter::writeBinary(path("matrix.hwmx"), matrix);
+    CHECK(MatrixReader::isBinary(path("matrix.hwmx")));
+    CHECK(!MatrixReader::isNumpy(path("matrix.hwmx")));
+    
+    // Same type: mapped, rows on cache lines as written
+    Matrix<double> mapped = MatrixReader::readBinary<double>(path("matrix.hwmx"));
+    CHECK(sameEntries(mapped, matrix));
+    CHECK(mapped.getStride() == paddedStride<double>(45));
+    CHECK(reinterpret_cast<uintptr_t>(mapped.getData()) % kCacheLineBytes == 0);
+    
+    // Factoring the mapping in place writes private pages, not the file
+    const long double determinant = DeterminantCalculator::calculateDeterminant(mapped);
+    CHECK(sameEntries(MatrixReader::readBinary<double>(path("matrix.hwmx")), matrix));
+    Matrix<double> copy = matrix.copy();
+    CHECK(determinant == DeterminantCalculator::calculateDeterminant(copy));
+    
+    // Other precisions convert; readFromFile recognizes the format
+    CHECK(sameEntries(MatrixReader::readBinary<long double>(path("matrix.hwmx")), matrix));
+    CHECK(sameEntries(MatrixReader::readFromFile<double>(path("matrix.hwmx")), matrix));
+    const Matrix<float> narrow = MatrixReader::readBinary<float>(path("matrix.hwmx"));
+    CHECK(narrow(3, 4) == static_cast<float>(matrix(3, 4)));
+    
+    // Long double written and read back, and the integral flag kept
+    Matrix<long double> integers(5);
+    for (size_t i = 0; i < 5; ++i) integers(i, (i * 2) % 5) = static_cast<long double>(i + 1);
+    integers.setIntegral(true);
+    MatrixWriter::writeBinary(path("int.hwmx"), integers);
+    const Matrix<long double> readIntegers = MatrixReader::readFromFile<long double>(path("int.hwmx"));
+    CHECK(readIntegers.isIntegral() && sameEntries(readIntegers, integers));
+    
+    // Empty matrix
+    MatrixWriter::writeBinary(path("empty.hwmx"), Matrix<double>(0));
+    CHECK(MatrixReader::readBinary<double>(path("empty.hwmx")).getSize() == 0);
+    
+    // Truncated data, a bad magic, text is not binary
+    std::filesystem::copy_file(path("matrix.hwmx"), path("truncated.hwmx"), std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::resize_file(path("truncated.hwmx"), 64 + 45 * 8);
+    CHECK_THROWS(MatrixReader::readBinary<double>(path("truncated.hwmx")));
+    std::ofstream(path("bad.hwmx")) << "HWMXMATRnot really";
+    CHECK_THROWS(MatrixReader::readBinary<double>(path("bad.hwmx")));
+    
+    // Headers whose element size disagrees with the scalar tag, or whose tag
+    // names no type: a double tag with 1-byte elements over 10^6 bytes would
+    // pass the size check for n = 1000 and be read as 8 * 10^6 bytes
+    auto writeHeader = [](const std::string& file, uint32_t scalar, uint32_t elementBytes, uint64_t n) 
+    {
+        char header[64] = { 'H', 'W', 'M', 'X', 'M', 'A', 'T', 'R' };
+        const uint32_t version = 1;
+        std::memcpy(header + 8, &version, 4);
+        std::memcpy(header + 12, &scalar, 4);
+        std::memcpy(header + 16, &elementBytes, 4);
+        std::memcpy(header + 24, &n, 8);
+        std::memcpy(header + 32, &n, 8);
+        std::ofstream out(file, std::ios::binary);
+        out.write(header, sizeof(header));
+        out << std::string(n * n, '\0');
+    };
+    writeHeader(path("narrow.hwmx"), 2, 1, 1000);
+    CHECK_THROWS(MatrixReader::readBinary<double>(path("narrow.hwmx")));
+    CHECK_THROWS(MatrixReader::readBinary<long double>(path("narrow.hwmx")));
+    CHECK_THROWS(MatrixReader::readFromFile<double>(path("narrow.hwmx")));
+    writeHeader(path("unknown.hwmx"), 9, 8, 10);
+    CHECK_THROWS(MatrixReader::readBinary<double>(path("unknown.hwmx")));
+    
+    writeText(path("text.txt"), matrix);
+    CHECK(!MatrixReader::isBinary(path("text.txt")));
+    CHECK_THROWS(MatrixReader::readBinary<double>(path("text.txt")));
+    
+    // The tile store refuses binary input instead of parsing it as text
+    CHECK_THROWS(FileMatrix<double>::importText(path("matrix.hwmx"), path("store.bin"), 16));
+}
+
+void checkNumpy() 
+{
+    const size_t n = 37;
+    const Matrix<double> matrix = TestSupport::randomMatrix<double>(n, 11);
+    Matrix<float> rounded(n);
+    for (size_t i = 0; i < n; ++i) 
+    {
+        for (size_t j = 0; j < n; ++j) rounded(i, j) = static_cast<float>(matrix(i, j));
+    }
+    std::string shape = "(";
+    shape += std::to_string(n) + ", " + std::to_string(n) + ")";
+    
+    for (bool fortranOrder : { false, true }) 
+    {
+        const std::vector<double> f8 = flatten<double>(matrix, fortranOrder);
+        const std::vector<float> f4 = flatten<float>(matrix, fortranOrder);
+        for (int version : { 1, 2 }) 
+        {
+            writeNumpy(path("f8.npy"), "<f8", fortranOrder, shape, f8.data(), f8.size() * 8, version);
+            writeNumpy(path("f4.npy"), "<f4", fortranOrder, shape, f4.data(), f4.size() * 4, version);
+            CHECK(MatrixReader::isNumpy(path("f8.npy")));
+            
+            CHECK_MSG(sameEntries(MatrixReader::readNumpy<double>(path("f8.npy")), matrix), "f8 fortran=" << fortranOrder << " v" << version);
+            CHECK_MSG(sameEntries(MatrixReader::readNumpy<long double>(path("f8.npy")), matrix), "f8 as long double");
+            CHECK_MSG(sameEntries(MatrixReader::readFromFile<float>(path("f4.npy")), rounded), "f4 fortran=" << fortranOrder);
+            CHECK_MSG(sameEntries(MatrixReader::readNumpy<double>(path("f4.npy")), rounded), "f4 as double");
+        }
+    }
+    
+    // C-order float64 with a 64-byte header is taken over without a copy:
+    // leading dimension n, data right after the header
+    writeNumpy(path("mapped.npy"), "<f8", false, shape, flatten<double>(matrix, false).data(), n * n * 8);
+    Matrix<double> mapped = MatrixReader::readNumpy<double>(path("mapped.npy"));
+    CHECK(mapped.getStride() == n);
+    Matrix<double> copy = matrix.copy();
+    CHECK(DeterminantCalculator::calculateDeterminant(mapped) == DeterminantCalculator::calculateDeterminant(copy));
+    CHECK(sameEntries(MatrixReader::readNumpy<double>(path("mapped.npy")), matrix));
+    
+    // Older writers aligned the data to 16 bytes only; those are copied
+    writeNumpy(path("aligned16.npy"), "<f8", false, shape, flatten<double>(matrix, false).data(), n * n * 8, 1, 16);
+    const Matrix<double> copied = MatrixReader::readNumpy<double>(path("aligned16.npy"));
+    CHECK(sameEntries(copied, matrix) && reinterpret_cast<uintptr_t>(copied.getData()) % kCacheLineBytes == 0);
+    
+    // Integer-valued arrays set the integral flag
+    const double integers[] = { 2, -1, 0, 3 };
+    writeNumpy(path("int.npy"), "<f8", false, "(2, 2)", integers, sizeof(integers));
+    const Matrix<double> readIntegers = MatrixReader::readNumpy<double>(path("int.npy"));
+    CHECK(readIntegers.isIntegral() && readIntegers(1, 1) == 3.0);
+    
+    writeNumpy(path("empty.npy"), "<f8", false, "(0, 0)", nullptr, 0);
+    CHECK(MatrixReader::readNumpy<double>(path("empty.npy")).getSize() == 0);
+    
+    // Rejected: not square, not 2-D, big-endian, integers, truncated, not .npy
+    const std::vector<double> zeros(12, 0.0);
+    writeNumpy(path("rect.npy"), "<f8", false, "(3, 4)", zeros.data(), 96);
+    writeNumpy(path("vector.npy"), "<f8", false, "(12,)", zeros.data(), 96);
+    writeNumpy(path("big.npy"), ">f8", false, "(2, 2)", zeros.data(), 32);
+    writeNumpy(path("i8.npy"), "<i8", false, "(2, 2)", zeros.data(), 32);
+    writeNumpy(path("truncated.npy"), "<f8", false, "(4, 4)", zeros.data(), 96);
+    CHECK_THROWS(MatrixReader::readNumpy<double>(path("rect.npy")));
+    CHECK_THROWS(MatrixReader::readNumpy<double>(path("vector.npy")));
+    CHECK_THROWS(MatrixReader::readNumpy<double>(path("big.npy")));
+    CHECK_THROWS(MatrixReader::readNumpy<double>(path("i8.npy")));
+    CHECK_THROWS(MatrixReader::readNumpy<double>(path("truncated.npy")));
+    CHECK_THROWS(MatrixReader::readNumpy<double>(path("text.txt")));
+    CHECK(!MatrixReader::isNumpy(path("text.txt")));
+    CHECK_THROWS(FileMatrix<double>::importText(path("mapped.npy"), path("store.bin"), 16));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) 
+{
+    scratch = argc > 2 ? argv[2] : std::filesystem::temp_directory_path().string();
+    
+    checkText();
+    checkBinary();
+    checkNumpy();
+    
+    return TestSupport::finish("readers");
+}
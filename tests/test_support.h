@@ -0,0 +1,94 @@
+// Minimal checks for the test executables: every failed check is printed
+// with its location and counted, and finish() turns the count into the
+// exit status ctest looks at.
+
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include "determinant.h"
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace TestSupport 
+{
+
+inline int failures = 0;
+inline int checks = 0;
+
+inline void report(bool passed, const char* file, int line, const std::string& what) 
+{
+    ++checks;
+    if (passed) return;
+    ++failures;
+    std::cerr << file << ":" << line << ": check failed: " << what << std::endl;
+}
+
+// Relative difference is what the engines can be held to; the signs and
+// exact zeros must match
+inline bool sameDeterminant(long double a, long double b, long double tolerance) 
+{
+    if (b == 0.0L) return a == 0.0L;
+    return std::fabs(a - b) <= tolerance * std::fabs(b);
+}
+
+// Relative difference of the logs of two determinants' magnitudes is what
+// the engines can be held to; the signs must match exactly
+inline bool sameLogDeterminant(const LinearAlgebra::DeterminantCalculator::LogDeterminant& a, 
+                               const LinearAlgebra::DeterminantCalculator::LogDeterminant& b, long double tolerance) 
+{
+    if (a.sign != b.sign) return false;
+    if (a.sign == 0) return true;
+    return std::fabs(static_cast<double>(a.logAbs - b.logAbs)) <= tolerance * std::max(1.0L, std::fabs(b.logAbs));
+}
+
+// Entries uniform in [-1, 1): well conditioned enough that every engine
+// agrees to near its working precision
+template <typename T>
+LinearAlgebra::Matrix<T> randomMatrix(size_t n, uint64_t seed) 
+{
+    std::mt19937_64 engine(seed);
+    std::uniform_real_distribution<double> entry(-1.0, 1.0);
+    LinearAlgebra::Matrix<T> matrix(n);
+    for (size_t i = 0; i < n; ++i) 
+    {
+        for (size_t j = 0; j < n; ++j) 
+        {
+            matrix(i, j) = static_cast<T>(entry(engine));
+        }
+    }
+    return matrix;
+}
+
+inline int finish(const char* area) 
+{
+    std::cout << area << ": " << checks - failures << "/" << checks << " checks passed" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+} // namespace TestSupport
+
+#define CHECK(condition) TestSupport::report(static_cast<bool>(condition), __FILE__, __LINE__, #condition)
+
+// Message built with stream syntax, for checks inside loops
+#define CHECK_MSG(condition, message) \
+    do \
+    { \
+        std::ostringstream what_; \
+        what_ << #condition << " [" << message << "]"; \
+        TestSupport::report(static_cast<bool>(condition), __FILE__, __LINE__, what_.str()); \
+    } while (0)
+    
+// The expression must throw an exception derived from std::exception
+#define CHECK_THROWS(expression) \
+    do \
+    { \
+        bool thrown_ = false; \
+        try { (void)(expression); } catch (const std::exception&) { thrown_ = true; } \
+        TestSupport::report(thrown_, __FILE__, __LINE__, "throws: " #expression); \
+    } while (0)
+    
+#endif // TEST_SUPPORT_H